@@ -13,12 +13,15 @@ extern "C"
 }
 
 void luaopen_class (lua_State * L);
+void luaopen_collection (lua_State * L);
 void luaopen_dirent (lua_State * L);
+void luaopen_dynamics (lua_State * L);
 void luaopen_graphics (lua_State * L);
 void luaopen_misc (lua_State * L);
 void luaopen_sequence (lua_State * L);
 void luaopen_sdl (lua_State * L);
 void luaopen_state (lua_State * L);
+void luaopen_steering (lua_State * L);
 void luaopen_ui (lua_State * L);
 void luaopen_voxel (lua_State * L);
 
@@ -46,6 +49,8 @@ namespace Lua
 	int V_U (lua_State * L, void (*func)(Uint));
 	int I_V (lua_State * L, int (*func)(void));
 
+	struct UserType;
+
 	struct UserType_Reg {
 		size_t mOffset;
 		char * mName;
@@ -158,7 +163,9 @@ namespace Lua
 	void class_Define (lua_State * L, char const * name, luaL_Reg const * methods, char const * closures[], int count, char const * base, Uint size);
 	void class_New (lua_State * L, char const * name, int count);
 	void class_SCons (lua_State * L, char const * base, int count);
+	UserType * GetUserType (lua_State * L, char const * name);
 	void PushUserType (lua_State * L, void * data, char const * name);
+	void PushUserType (lua_State * L, void * data, UserType * pType);
 	void RegisterUserType (lua_State * L, char const * name, UserType_Reg * reg, Uint count, size_t size, char * format, ...);
 
 	void MemberBindFuncs (lua_State * L, luaL_Reg const * getters, luaL_Reg const * setters, Member_Reg const * members, int count, Members_Lookup lookup, char const * where = 0, bool bPropagateOnFail = false);
@@ -10,17 +10,22 @@ int main (int argc, char * argv[])
 
 	// Give Lua some useful tools.
 	luaopen_class(L);
+	luaopen_collection(L);
 	luaopen_dirent(L);
+	luaopen_dynamics(L);
 	luaopen_graphics(L);
 	luaopen_misc(L);
 	luaopen_sequence(L);
 	luaopen_sdl(L);
 	luaopen_state(L);
+	luaopen_steering(L);
 	luaopen_ui(L);
 	luaopen_voxel(L);
 
-	// Boot and run the application, and close Lua when done.
-	luaL_loadfile(L, "Scripts/Boot.txt");	// boot
+	// Boot and run the application, and close Lua when done. A script named on the command
+	// line, e.g. one of the checks under Tests, is run in place of the boot script.
+	if (luaL_loadfile(L, argc > 1 ? argv[1] : "Scripts/Boot.txt") != 0) lua_error(L);	// boot
+
 	lua_call(L, 0, 0);
 	lua_close(L);
 
@@ -0,0 +1,720 @@
+#include "App.h"
+#include <vector>
+
+/// @brief Environment table indices
+/// @note Each type is assigned a slot, whose elements are kept in a dense array; slot s's array is stored at eArrays + s
+enum {
+	eSlots = 1,	///< Type -> slot table index
+	eTypes,	///< Slot -> type table index
+	eIterators,	///< Custom iterator table index
+	eFrames,///< Free custom iteration frames index
+	eArrays	///< First element array index
+};
+
+/// @brief Cursor stride per slot
+/// @note Iteration cursors are of the form slot * CursorStride + position
+static const lua_Number CursorStride = 1 << 20;
+
+/// @brief Handle value marking an unused entry or the end of the free list
+static const Lua::Uint Free = ~0U;
+
+/// @brief Element collection, as seen from Lua
+/// @note The elements themselves live in the userdatum's environment table
+struct Collection {
+	/// @brief Handle entry
+	struct Entry {
+		Lua::Uint mSlot;///< Slot of handle's element, or Free if unused
+		Lua::Uint mIndex;	///< Index of element in slot's array; if unused, next free handle
+	};
+
+	std::vector<std::vector<Lua::Uint> > mHandles;	///< Handles of each slot's elements, in array order
+	std::vector<Entry> mEntries;///< Entries, by handle - 1
+	Lua::Uint mFree;///< First free handle - 1, or Free if none
+	Lua::Uint mRevision;///< Revision number, changed whenever elements are added or removed
+
+	Collection (void) : mFree(Free), mRevision(0) {}
+
+	/// @brief Allocates a handle
+	/// @param slot Slot of element
+	/// @param index Index of element in slot's array
+	/// @return Handle
+	Lua::Uint Alloc (Lua::Uint slot, Lua::Uint index)
+	{
+		Lua::Uint handle = mFree;
+
+		if (Free == handle)
+		{
+			handle = Lua::Uint(mEntries.size());
+
+			mEntries.push_back(Entry());
+		}
+
+		else mFree = mEntries[handle].mIndex;
+
+		mEntries[handle].mSlot = slot;
+		mEntries[handle].mIndex = index;
+
+		return handle + 1;
+	}
+
+	/// @brief Releases a handle
+	/// @param handle Handle to release
+	void Release (Lua::Uint handle)
+	{
+		mEntries[handle - 1].mSlot = Free;
+		mEntries[handle - 1].mIndex = mFree;
+
+		mFree = handle - 1;
+	}
+
+	/// @brief Indicates whether a handle refers to an element
+	/// @param handle Handle to test
+	/// @return If true, the handle is in use
+	bool IsValid (lua_Integer handle)
+	{
+		return handle >= 1 && handle <= lua_Integer(mEntries.size()) && mEntries[size_t(handle - 1)].mSlot != Free;
+	}
+};
+
+///
+/// Helpers
+///
+static inline Collection * UC (lua_State * L, int index)
+{
+	return *static_cast<Collection**>(Lua::UD(L, index));
+}
+
+/// @brief Splits an iteration cursor
+/// @param L Lua state
+/// @param index Stack index of cursor
+/// @param slot [out] Slot
+/// @return Position within slot
+static Lua::Uint Split (lua_State * L, int index, Lua::Uint & slot)
+{
+	lua_Number cursor = lua_tonumber(L, index);
+
+	slot = Lua::Uint(cursor / CursorStride);
+
+	return Lua::Uint(cursor - slot * CursorStride);
+}
+
+/// @brief Pushes an iterator step function
+/// @param step Step function
+/// @note Each step function is made once and kept in the registry, so iteration makes no garbage
+static void PushStep (lua_State * L, lua_CFunction step)
+{
+	lua_pushlightuserdata(L, (void*)step);	// ..., key
+	lua_rawget(L, LUA_REGISTRYINDEX);	// ..., step
+}
+
+/// @brief Pushes a cursor and the element at a slot's index
+/// @param slot Slot
+/// @param pos Cursor position
+/// @param index Index of element in slot's array
+/// @note collection: Collection handle
+/// @return 2 (cursor, element)
+static int PushElement (lua_State * L, Lua::Uint slot, Lua::Uint pos, Lua::Uint index)
+{
+	lua_pushnumber(L, slot * CursorStride + pos);	// C, cursor, cursor'
+	lua_getfenv(L, 1);	// C, cursor, cursor', E
+	lua_rawgeti(L, -1, eArrays + slot);	// C, cursor, cursor', E, array
+	lua_rawgeti(L, -1, index);	// C, cursor, cursor', E, array, element
+	lua_replace(L, -3);	// C, cursor, cursor', element, array
+	lua_pop(L, 1);	// C, cursor, cursor', element
+
+	return 2;
+}
+
+/// @brief Finds the slot assigned to a type
+/// @param index Stack index of type
+/// @return Slot, or Free if the type has none
+/// @note collection: Collection handle
+static Lua::Uint FindSlot (lua_State * L, int index)
+{
+	lua_getfenv(L, 1);	// C, ..., E
+	lua_rawgeti(L, -1, eSlots);	// C, ..., E, slots
+	lua_pushvalue(L, index);// C, ..., E, slots, type
+	lua_rawget(L, -2);	// C, ..., E, slots, slot
+
+	Lua::Uint slot = lua_isnil(L, -1) ? Free : Lua::Uint(lua_tointeger(L, -1));
+
+	lua_pop(L, 3);	// C, ...
+
+	return slot;
+}
+
+/// @brief Pushes the type of an element, when none was specified
+/// @param index Stack index of element
+/// @note Class instances may supply a Type method; otherwise, the class or Lua type is used
+static void PushType (lua_State * L, int index)
+{
+	lua_getglobal(L, "class");	// ..., class
+	lua_getfield(L, -1, "type");// ..., class, class.type
+	lua_pushvalue(L, index);// ..., class, class.type, element
+	lua_call(L, 1, 1);	// ..., class, ctype
+	lua_replace(L, -2);	// ..., ctype
+
+	if (lua_isnil(L, -1))
+	{
+		lua_pop(L, 1);	// ...
+		lua_pushstring(L, luaL_typename(L, index));	// ..., type
+
+		return;
+	}
+
+	lua_getfield(L, index, "InvokeIf_");// ..., ctype, InvokeIf_
+	lua_pushvalue(L, index);// ..., ctype, InvokeIf_, element
+	lua_pushliteral(L, "Type");	// ..., ctype, InvokeIf_, element, "Type"
+	lua_call(L, 2, 1);	// ..., ctype, type
+
+	if (!lua_isnil(L, -1)) lua_replace(L, -2);	// ..., type
+
+	else lua_pop(L, 1);	// ..., ctype
+}
+
+///
+/// Iterator steps
+///
+
+/// @brief Steps through all elements
+/// @note collection, cursor: Collection handle, previous cursor
+static int StepAll (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	Lua::Uint slot, index = Split(L, 2, slot) + 1;
+
+	// Skip past the end of the current slot, to the next non-empty one.
+	while (slot < pC->mHandles.size() && index > pC->mHandles[slot].size()) ++slot, index = 1;
+
+	if (slot == pC->mHandles.size()) return 0;
+
+	return PushElement(L, slot, index, index);
+}
+
+/// @brief Steps through the elements of one type
+/// @note collection, cursor: Collection handle, previous cursor
+static int StepType (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	Lua::Uint slot, index = Split(L, 2, slot) + 1;
+
+	if (index > pC->mHandles[slot].size()) return 0;
+
+	return PushElement(L, slot, index, index);
+}
+
+/// @brief Steps through the elements supplied by a custom iterator
+/// @note frame, cursor: Iteration frame, previous cursor
+/// @note A frame holds the collection, followed by the element indices supplied by the iterator;
+///       once the iteration is done, it goes back to the collection to be reused
+static int StepCustom (lua_State * L)
+{
+	lua_rawgeti(L, 1, 1);	// frame, cursor, C
+
+	if (!lua_toboolean(L, 3)) return 0;
+
+	Lua::Uint slot, pos = Split(L, 2, slot) + 1;
+
+	lua_rawgeti(L, 1, pos + 1);	// frame, cursor, C, index
+
+	if (lua_isnil(L, 4))
+	{
+		lua_getfenv(L, 3);	// frame, cursor, C, nil, E
+		lua_rawgeti(L, 5, eFrames);	// frame, cursor, C, nil, E, frames
+		lua_pushvalue(L, 1);// frame, cursor, C, nil, E, frames, frame
+		lua_rawseti(L, 6, int(lua_objlen(L, 6) + 1));	// frame, cursor, C, nil, E, frames = { ..., frame }
+		lua_pushboolean(L, 0);	// frame, cursor, C, nil, E, frames, false
+		lua_rawseti(L, 1, 1);	// frame = { false, ... }, cursor, C, nil, E, frames
+
+		return 0;
+	}
+
+	Lua::Uint index = Lua::Uint(lua_tointeger(L, 4));
+
+	lua_pop(L, 1);	// frame, cursor, C
+	lua_replace(L, 1);	// C, cursor
+
+	return PushElement(L, slot, pos, index);
+}
+
+/// @brief Steps through the types with elements
+/// @note collection, type: Collection handle, previous type
+static int StepTypes (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	Lua::Uint slot = 0;
+
+	if (!lua_isnil(L, 2))
+	{
+		slot = FindSlot(L, 2);
+
+		if (Free == slot) return 0;
+
+		++slot;
+	}
+
+	while (slot < pC->mHandles.size() && pC->mHandles[slot].empty()) ++slot;
+
+	if (slot >= pC->mHandles.size()) return 0;
+
+	lua_getfenv(L, 1);	// C, type, E
+	lua_rawgeti(L, 3, eTypes);	// C, type, E, types
+	lua_rawgeti(L, 4, slot + 1);// C, type, E, types, type'
+
+	return 1;
+}
+
+///
+/// Collection functions
+///
+static int CollectionAddElement (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	lua_settop(L, 4);	// C, index, element, type
+
+	// Determine the type to which the element is added, assigning it a slot if it is new.
+	if (lua_isnil(L, 4))
+	{
+		PushType(L, 3);	// C, index, element, nil, type
+		lua_replace(L, 4);	// C, index, element, type
+	}
+
+	Lua::Uint slot = FindSlot(L, 4);
+
+	lua_getfenv(L, 1);	// C, index, element, type, E
+
+	if (Free == slot)
+	{
+		slot = Lua::Uint(pC->mHandles.size());
+
+		pC->mHandles.push_back(std::vector<Lua::Uint>());
+
+		lua_rawgeti(L, 5, eSlots);	// C, index, element, type, E, slots
+		lua_pushvalue(L, 4);// C, index, element, type, E, slots, type
+		lua_pushinteger(L, slot);	// C, index, element, type, E, slots, type, slot
+		lua_rawset(L, 6);	// C, index, element, type, E, slots = { ..., type = slot }
+		lua_rawgeti(L, 5, eTypes);	// C, index, element, type, E, slots, types
+		lua_pushvalue(L, 4);// C, index, element, type, E, slots, types, type
+		lua_rawseti(L, 7, slot + 1);// C, index, element, type, E, slots, types = { ..., type }
+		lua_newtable(L);// C, index, element, type, E, slots, types, {}
+		lua_rawseti(L, 5, eArrays + slot);	// C, index, element, type, E = { ..., [eArrays + slot] = {} }, slots, types
+		lua_settop(L, 5);	// C, index, element, type, E
+	}
+
+	lua_rawgeti(L, 5, eArrays + slot);	// C, index, element, type, E, array
+
+	// If the index is unspecified, append the element; otherwise, put it in a slot in
+	// the type if the index is valid.
+	std::vector<Lua::Uint> & handles = pC->mHandles[slot];
+
+	lua_Integer count = lua_Integer(handles.size()), index = lua_isnil(L, 2) ? count + 1 : lua_tointeger(L, 2);
+
+	if (index <= -1 && index >= -count) index += count + 1;
+
+	if (index == count + 1) handles.push_back(pC->Alloc(slot, Lua::Uint(count)));
+
+	else if (index < 1 || index > count) return 0;
+
+	++pC->mRevision;
+
+	lua_pushvalue(L, 3);// C, index, element, type, E, array, element
+	lua_rawseti(L, 6, int(index));	// C, index, element, type, E, array = { ..., [index] = element }
+	lua_pushinteger(L, handles[size_t(index - 1)]);	// C, index, element, type, E, array, handle
+
+	return 1;
+}
+
+static int CollectionClear (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	++pC->mRevision;
+
+	// Clear either the one type or all of them. Slots are kept, to be reused.
+	Lua::Uint first = 0, last = Lua::Uint(pC->mHandles.size());
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		first = FindSlot(L, 2);
+
+		if (Free == first) return 0;
+
+		last = first + 1;
+	}
+
+	lua_getfenv(L, 1);	// C[, type], E
+
+	for (Lua::Uint slot = first; slot < last; ++slot)
+	{
+		std::vector<Lua::Uint> & handles = pC->mHandles[slot];
+
+		lua_rawgeti(L, -1, eArrays + slot);	// C[, type], E, array
+
+		for (Lua::Uint i = 0; i < handles.size(); ++i)
+		{
+			pC->Release(handles[i]);
+
+			lua_pushnil(L);	// C[, type], E, array, nil
+			lua_rawseti(L, -2, i + 1);	// C[, type], E, array = { ..., [i + 1] = nil }
+		}
+
+		lua_pop(L, 1);	// C[, type], E
+
+		handles.clear();
+	}
+
+	return 0;
+}
+
+static int CollectionGetByHandle (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	lua_Integer handle = luaL_checkinteger(L, 2);
+
+	if (!pC->IsValid(handle)) return 0;
+
+	Collection::Entry & entry = pC->mEntries[size_t(handle - 1)];
+
+	lua_getfenv(L, 1);	// C, handle, E
+	lua_rawgeti(L, 3, eArrays + entry.mSlot);	// C, handle, E, array
+	lua_rawgeti(L, 4, entry.mIndex + 1);// C, handle, E, array, element
+	lua_rawgeti(L, 3, eTypes);	// C, handle, E, array, element, types
+	lua_rawgeti(L, 6, entry.mSlot + 1);	// C, handle, E, array, element, types, type
+	lua_replace(L, 6);	// C, handle, E, array, element, type
+	lua_pushinteger(L, entry.mIndex + 1);	// C, handle, E, array, element, type, index
+
+	return 3;
+}
+
+static int CollectionGetCount (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	size_t count = 0;
+
+	// Count the one type or, if none was specified, all of them.
+	if (lua_isnoneornil(L, 2))
+	{
+		for (size_t slot = 0; slot < pC->mHandles.size(); ++slot) count += pC->mHandles[slot].size();
+	}
+
+	else
+	{
+		Lua::Uint slot = FindSlot(L, 2);
+
+		if (slot != Free) count = pC->mHandles[slot].size();
+	}
+
+	lua_pushinteger(L, lua_Integer(count));
+
+	return 1;
+}
+
+/// @brief Resolves a type and index to an element's position
+/// @param pC Collection
+/// @param slot [out] Slot of element
+/// @return Index of element in slot's array, or 0 if no such element exists
+/// @note collection, type, index: Collection handle, element type, index (negative indices count from the end)
+static lua_Integer Resolve (lua_State * L, Collection * pC, Lua::Uint & slot)
+{
+	slot = FindSlot(L, 2);
+
+	if (Free == slot || lua_isnoneornil(L, 3)) return 0;
+
+	lua_Integer count = lua_Integer(pC->mHandles[slot].size()), index = lua_tointeger(L, 3);
+
+	if (index <= -1 && index >= -count) return index + count + 1;
+
+	return index >= 1 && index <= count ? index : 0;
+}
+
+static int CollectionGetElement (lua_State * L)
+{
+	Lua::Uint slot;
+
+	lua_Integer index = Resolve(L, UC(L, 1), slot);
+
+	if (0 == index) return 0;
+
+	lua_getfenv(L, 1);	// C, type, index, E
+	lua_rawgeti(L, -1, eArrays + slot);	// C, type, index, E, array
+	lua_rawgeti(L, -1, int(index));	// C, type, index, E, array, element
+
+	return 1;
+}
+
+static int CollectionGetHandle (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	Lua::Uint slot;
+
+	lua_Integer index = Resolve(L, pC, slot);
+
+	if (0 == index) return 0;
+
+	lua_pushinteger(L, pC->mHandles[slot][size_t(index - 1)]);	// C, type, index, handle
+
+	return 1;
+}
+
+static int CollectionGetRevision (lua_State * L)
+{
+	lua_pushinteger(L, UC(L, 1)->mRevision);
+
+	return 1;
+}
+
+static int CollectionGetTypes (lua_State * L)
+{
+	PushStep(L, StepTypes);	// C, step
+	lua_pushvalue(L, 1);// C, step, C
+
+	return 2;
+}
+
+static int CollectionIter (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	// With no type, iterate over every element. Otherwise, restrict to the type; if it
+	// has none, start past the final slot, which ends the iteration at once.
+	Lua::Uint slot = lua_isnoneornil(L, 2) ? 0 : FindSlot(L, 2);
+	lua_CFunction step = StepAll;
+
+	if (Free == slot) slot = Lua::Uint(pC->mHandles.size());
+
+	else if (!lua_isnoneornil(L, 2))
+	{
+		step = StepType;
+
+		// If there is a custom iterator installed, invoke it and load up the indices that
+		// it supplies, skipping any not in the type. The indices go into a frame of their
+		// own, so that iterations may be nested; frames are reused once done with.
+		lua_getfenv(L, 1);	// C, type, ..., E
+		lua_rawgeti(L, -1, eIterators);	// C, type, ..., E, iterators
+		lua_pushvalue(L, 2);// C, type, ..., E, iterators, type
+		lua_rawget(L, -2);	// C, type, ..., E, iterators, iterator
+
+		if (!lua_isnil(L, -1))
+		{
+			int top = lua_gettop(L);
+
+			for (int i = 3; i < top - 2; ++i) lua_pushvalue(L, i);
+
+			lua_call(L, top - 5, 3);// C, type, ..., E, iterators, f, s, control
+			lua_rawgeti(L, top - 2, eFrames);	// C, type, ..., E, iterators, f, s, control, frames
+
+			int nfree = int(lua_objlen(L, -1));
+
+			if (nfree > 0)
+			{
+				lua_rawgeti(L, -1, nfree);	// C, type, ..., E, iterators, f, s, control, frames, frame
+				lua_pushnil(L);	// C, type, ..., E, iterators, f, s, control, frames, frame, nil
+				lua_rawseti(L, -3, nfree);	// C, type, ..., E, iterators, f, s, control, frames = { ... }, frame
+			}
+
+			else lua_newtable(L);	// C, type, ..., E, iterators, f, s, control, frames, frame
+
+			lua_replace(L, -2);	// C, type, ..., E, iterators, f, s, control, frame
+			lua_pushvalue(L, 1);// C, type, ..., E, iterators, f, s, control, frame, C
+			lua_rawseti(L, -2, 1);	// C, type, ..., E, iterators, f, s, control, frame = { C }
+			lua_insert(L, -4);	// C, type, ..., E, iterators, frame, f, s, control
+
+			int count = 1;
+
+			for (;;)
+			{
+				lua_pushvalue(L, -3);	// C, type, ..., E, iterators, frame, f, s, control, f
+				lua_pushvalue(L, -3);	// C, type, ..., E, iterators, frame, f, s, control, f, s
+				lua_pushvalue(L, -3);	// C, type, ..., E, iterators, frame, f, s, control, f, s, control
+				lua_call(L, 2, 1);	// C, type, ..., E, iterators, frame, f, s, control, index
+
+				if (lua_isnil(L, -1)) break;
+
+				lua_Integer index = lua_tointeger(L, -1);
+
+				if (index >= 1 && index <= lua_Integer(pC->mHandles[slot].size()))
+				{
+					lua_pushinteger(L, index);	// C, type, ..., E, iterators, frame, f, s, control, index, index
+					lua_rawseti(L, -6, ++count);// C, type, ..., E, iterators, frame = { C, ..., index }, f, s, control, index
+				}
+
+				lua_replace(L, -2);	// C, type, ..., E, iterators, frame, f, s, index
+			}
+
+			lua_rawseti(L, -5, count + 1);	// C, type, ..., E, iterators, frame = { C, ..., nil }, f, s, control
+			lua_pop(L, 3);	// C, type, ..., E, iterators, frame
+			PushStep(L, StepCustom);// C, type, ..., E, iterators, frame, step
+			lua_insert(L, -2);	// C, type, ..., E, iterators, step, frame
+			lua_pushnumber(L, slot * CursorStride);	// C, type, ..., E, iterators, step, frame, cursor
+
+			return 3;
+		}
+	}
+
+	PushStep(L, step);	// C, ..., step
+	lua_pushvalue(L, 1);// C, ..., step, C
+	lua_pushnumber(L, slot * CursorStride);	// C, ..., step, C, cursor
+
+	return 3;
+}
+
+static int CollectionPack (lua_State * L)
+{
+	CollectionGetCount(L);	// C[, type, ...], count
+
+	int count = int(lua_tointeger(L, -1));
+
+	lua_pop(L, 1);	// C[, type, ...]
+
+	// Run the iterator, ordering the elements as it supplies them.
+	lua_pushcfunction(L, CollectionIter);	// C[, type, ...], Iter
+	lua_insert(L, 1);	// Iter, C[, type, ...]
+	lua_call(L, lua_gettop(L) - 1, 3);	// step, C, cursor
+	lua_createtable(L, count, 0);	// step, C, cursor, elements
+	lua_insert(L, 1);	// elements, step, C, cursor
+
+	for (int index = 1; ; ++index)
+	{
+		lua_pushvalue(L, 2);// elements, step, C, cursor, step
+		lua_pushvalue(L, 3);// elements, step, C, cursor, step, C
+		lua_pushvalue(L, 4);// elements, step, C, cursor, step, C, cursor
+		lua_call(L, 2, 2);	// elements, step, C, cursor, cursor', element
+
+		if (lua_isnil(L, 5)) break;
+
+		lua_rawseti(L, 1, index);	// elements = { ..., element }, step, C, cursor, cursor'
+		lua_replace(L, 4);	// elements, step, C, cursor'
+	}
+
+	lua_settop(L, 1);	// elements
+
+	return 1;
+}
+
+static int CollectionRemove (lua_State * L)
+{
+	Collection * pC = UC(L, 1);
+
+	lua_Integer handle = luaL_checkinteger(L, 2);
+
+	if (!pC->IsValid(handle)) return 0;
+
+	++pC->mRevision;
+
+	// Move the final element of the type into the removed one's place.
+	Collection::Entry entry = pC->mEntries[size_t(handle - 1)];
+
+	std::vector<Lua::Uint> & handles = pC->mHandles[entry.mSlot];
+
+	Lua::Uint last = Lua::Uint(handles.size());
+
+	lua_getfenv(L, 1);	// C, handle, E
+	lua_rawgeti(L, 3, eArrays + entry.mSlot);	// C, handle, E, array
+	lua_rawgeti(L, 4, entry.mIndex + 1);// C, handle, E, array, element
+	lua_rawgeti(L, 4, last);// C, handle, E, array, element, final
+	lua_rawseti(L, 4, entry.mIndex + 1);// C, handle, E, array = { ..., [index] = final }, element
+	lua_pushnil(L);	// C, handle, E, array, element, nil
+	lua_rawseti(L, 4, last);// C, handle, E, array = { ..., [last] = nil }, element
+
+	handles[entry.mIndex] = handles.back();
+
+	pC->mEntries[handles[entry.mIndex] - 1].mIndex = entry.mIndex;
+
+	handles.pop_back();
+
+	pC->Release(Lua::Uint(handle));
+
+	return 1;
+}
+
+static int CollectionSetIterator (lua_State * L)
+{
+	lua_settop(L, 3);	// C, type, iterator
+	lua_getfenv(L, 1);	// C, type, iterator, E
+	lua_rawgeti(L, 4, eIterators);	// C, type, iterator, E, iterators
+	lua_pushvalue(L, 2);// C, type, iterator, E, iterators, type
+	lua_pushvalue(L, 3);// C, type, iterator, E, iterators, type, iterator
+	lua_rawset(L, 5);	// C, type, iterator, E, iterators = { ..., type = iterator }
+
+	return 0;
+}
+
+///
+/// Garbage collector
+///
+static int Collection__gc (lua_State * L)
+{
+	delete UC(L, 1);
+
+	return 0;
+}
+
+///
+/// Function table
+///
+#define M_(w) { #w, Collection##w }
+
+static const luaL_reg CollectionFuncs[] = {
+	M_(__gc),
+	M_(AddElement),
+	M_(Clear),
+	M_(GetByHandle),
+	M_(GetCount),
+	M_(GetElement),
+	M_(GetHandle),
+	M_(GetRevision),
+	M_(GetTypes),
+	M_(Iter),
+	M_(Pack),
+	M_(Remove),
+	M_(SetIterator),
+	{ 0, 0 }
+};
+
+#undef M_
+
+///
+/// New function
+///
+static int CollectionNew (lua_State * L)
+{
+	Collection * pC = new Collection;
+
+	memcpy(Lua::UD(L, 1), &pC, sizeof(Collection*));
+
+	// Give the instance an environment to hold its elements.
+	lua_createtable(L, eArrays, 0);	// C, ..., E
+
+	for (int index = eSlots; index < eArrays; ++index)
+	{
+		lua_newtable(L);// C, ..., E, {}
+		lua_rawseti(L, -2, index);	// C, ..., E = { ..., [index] = {} }
+	}
+
+	lua_setfenv(L, 1);	// C, ...
+
+	return 0;
+}
+
+/// @brief Binds the collection class to the Lua scripting system
+void luaopen_collection (lua_State * L)
+{
+	Lua::class_Define(L, "Collection", CollectionFuncs, CollectionNew, 0, sizeof(Collection*));
+
+	// Make the step functions.
+	lua_CFunction steps[] = { StepAll, StepCustom, StepType, StepTypes };
+
+	for (size_t index = 0; index < sizeof(steps) / sizeof(lua_CFunction); ++index)
+	{
+		lua_pushlightuserdata(L, (void*)steps[index]);	// key
+		lua_pushcfunction(L, steps[index]);	// key, step
+		lua_rawset(L, LUA_REGISTRYINDEX);	// stack clear
+	}
+}
\ No newline at end of file
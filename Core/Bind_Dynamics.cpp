@@ -0,0 +1,897 @@
+#include "App.h"
+#include "Dynamics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/// @brief Wall hierarchy, as seen from Lua
+struct WallTree {
+	Dynamics::Tree mTree;	///< Hierarchy over wall bounds
+	std::vector<int> mIndices;	///< Collection indices of walls
+	std::vector<Lua::Uint> mFound;	///< Scratch buffer for queries
+};
+
+/// @brief Planned shot, as seen from Lua
+/// @note The shot leads, so that its members have the same offsets in the datum
+struct ShotDatum {
+	Dynamics::Shot mShot;	///< Shot
+	float mMotion[3];	///< Launch motion
+};
+
+/// @brief Material registry environment table indices
+enum {
+	eIDs = 1,	///< Type -> ID table index
+	eResponses	///< Response array index
+};
+
+/// @brief Registry of material responses, between types interned as small IDs
+/// @note The response functions live in the userdatum's environment table
+struct MaterialRegistry {
+	std::vector<int> mMatrix;	///< Response indices, by ID pair; 0 if the pair has no response
+	std::vector<std::pair<Lua::Uint, Lua::Uint> > mPairs;	///< ID pairs with responses, in order registered
+	Lua::Uint mCount;	///< Count of IDs assigned
+	Lua::Uint mSide;///< Count of IDs covered by the matrix
+	Lua::Uint mRevision;///< Revision number, changed whenever a response is registered
+
+	MaterialRegistry (void) : mCount(0), mSide(0), mRevision(0) {}
+
+	/// @brief Gets a pair's entry in the matrix
+	/// @param id1 ID of first type
+	/// @param id2 ID of second type
+	/// @return Response index
+	/// @note The matrix is grown to cover all assigned IDs, if necessary
+	int & At (Lua::Uint id1, Lua::Uint id2)
+	{
+		if (mSide < mCount)
+		{
+			std::vector<int> matrix(mCount * mCount, 0);
+
+			for (Lua::Uint i = 0; i < mSide; ++i) std::copy(mMatrix.begin() + i * mSide, mMatrix.begin() + (i + 1) * mSide, matrix.begin() + i * mCount);
+
+			mMatrix.swap(matrix);
+
+			mSide = mCount;
+		}
+
+		return mMatrix[id1 * mSide + id2];
+	}
+};
+
+///
+/// Type handlers
+///
+template<typename T> static T * UDT (lua_State * L, int index)
+{
+	return *static_cast<T**>(Lua::UD(L, index));
+}
+
+template<typename T> static T * UTT (lua_State * L, int index)
+{
+	return static_cast<T*>(Lua::UT(L, index));
+}
+
+static inline Dynamics::World * UW (lua_State * L, int index)
+{
+	return UDT<Dynamics::World>(L, index);
+}
+
+static inline WallTree * UWT (lua_State * L, int index)
+{
+	return UDT<WallTree>(L, index);
+}
+
+static inline MaterialRegistry * UMR (lua_State * L, int index)
+{
+	return UDT<MaterialRegistry>(L, index);
+}
+
+static inline Dynamics::Path * UP (lua_State * L, int index)
+{
+	return UDT<Dynamics::Path>(L, index);
+}
+
+/// @brief Pushes a vector onto the stack
+/// @note The vector type is looked up on first use and kept
+static void PushVector (lua_State * L, Dynamics::Vector const & v)
+{
+	static Lua::UserType * spVector;
+
+	if (0 == spVector) spVector = Lua::GetUserType(L, "Vector");
+
+	Lua::PushUserType(L, const_cast<Dynamics::Vector*>(&v), spVector);
+}
+
+/// @brief Pushes a path state, as an object would save it
+/// @param state State to push
+/// @note The heading runs along the ground, as with a ball's
+static void PushState (lua_State * L, Dynamics::PathState const & state)
+{
+	Dynamics::Vector motion = state.mMotion, position = state.mPosition;
+	Dynamics::Vector heading(motion.m[0], 0.0f, motion.m[0] != 0.0f || motion.m[2] != 0.0f ? motion.m[2] : 1.0f);
+
+	heading = ~heading;
+
+	lua_createtable(L, 0, 3);	// {}
+	PushVector(L, heading);	// {}, heading
+	lua_setfield(L, -2, "heading");	// { heading = heading }
+	PushVector(L, motion);// { heading }, motion
+	lua_setfield(L, -2, "motion");	// { heading, motion = motion }
+	PushVector(L, position);	// { heading, motion }, position
+	lua_setfield(L, -2, "position");// { heading, motion, position = position }
+}
+
+/// @brief Pushes a planned shot
+/// @param shot Shot to push
+/// @param direction Unit direction of the shot along the ground
+static void PushShot (lua_State * L, Dynamics::Shot const & shot, Dynamics::Vector const & direction)
+{
+	Dynamics::Vector motion = direction * (shot.mSpeed * cosf(shot.mAngle)) + Dynamics::Vector(0.0f, shot.mSpeed * sinf(shot.mAngle), 0.0f);
+
+	ShotDatum datum;
+
+	datum.mShot = shot;
+
+	std::copy(motion.m, motion.m + 3, datum.mMotion);
+
+	lua_pushlightuserdata(L, &datum);	// datum
+
+	Lua::class_New(L, "DynamicsShot", 1);	// shot
+}
+
+/// @brief Reads an array of numbers
+/// @param index Stack index of array
+/// @param values [out] Numbers read
+static void GetFloats (lua_State * L, int index, std::vector<float> & values)
+{
+	values.resize(lua_objlen(L, index));
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		lua_rawgeti(L, index, int(i + 1));	// ..., value
+
+		values[i] = float(lua_tonumber(L, -1));
+
+		lua_pop(L, 1);	// ...
+	}
+}
+
+/// @brief Gets the ID of a type, assigning one if it is new
+/// @param pMR Material registry
+/// @param index Stack index of type
+/// @return Type ID
+/// @note registry: Material registry handle
+static Lua::Uint GetID (lua_State * L, MaterialRegistry * pMR, int index)
+{
+	lua_getfenv(L, 1);	// MR, ..., E
+	lua_rawgeti(L, -1, eIDs);	// MR, ..., E, ids
+	lua_pushvalue(L, index);// MR, ..., E, ids, type
+	lua_rawget(L, -2);	// MR, ..., E, ids, id
+
+	if (lua_isnil(L, -1))
+	{
+		lua_pushvalue(L, index);// MR, ..., E, ids, nil, type
+		lua_pushinteger(L, pMR->mCount);// MR, ..., E, ids, nil, type, id
+		lua_rawset(L, -4);	// MR, ..., E, ids = { ..., type = id }, nil
+
+		lua_pop(L, 3);	// MR, ...
+
+		return pMR->mCount++;
+	}
+
+	Lua::Uint id = Lua::Uint(lua_tointeger(L, -1));
+
+	lua_pop(L, 3);	// MR, ...
+
+	return id;
+}
+
+///
+/// World functions
+///
+static int WorldAddObject (lua_State * L)
+{
+	UW(L, 1)->AddObject(*UTT<Dynamics::Sphere>(L, 2), *UTT<Dynamics::Vector>(L, 3), Lua::U(L, 4), lua_isnoneornil(L, 5) ? 0 : Lua::U(L, 5));
+
+	return 0;
+}
+
+static int WorldAddWall (lua_State * L)
+{
+	UW(L, 1)->AddWall(*UTT<Dynamics::Quad>(L, 2), Lua::U(L, 3));
+
+	return 0;
+}
+
+static int WorldClearMaterials (lua_State * L)
+{
+	UW(L, 1)->ClearMaterials();
+
+	return 0;
+}
+
+static int WorldClearObjects (lua_State * L)
+{
+	UW(L, 1)->ClearObjects();
+
+	return 0;
+}
+
+static int WorldClearWalls (lua_State * L)
+{
+	UW(L, 1)->ClearWalls();
+
+	return 0;
+}
+
+static int WorldFindHits (lua_State * L)
+{
+	Dynamics::World * pW = UW(L, 1);
+
+	float fTime = pW->FindHits(Lua::F(L, 2));
+
+	// If nothing was hit, supply the step as is, to avoid rounding it away.
+	if (pW->GetContactCount() > 0) lua_pushnumber(L, fTime);	// world, step, time
+
+	else lua_pushvalue(L, 2);	// world, step, step
+
+	lua_pushinteger(L, pW->GetContactCount());	// world, step, time, count
+	lua_pushboolean(L, pW->IsStuck());	// world, step, time, count, bStuck
+
+	return 3;
+}
+
+static int WorldGetHit (lua_State * L)
+{
+	Dynamics::World * pW = UW(L, 1);
+
+	Lua::Uint index = Lua::U(L, 2);
+
+	if (index < 1 || index > pW->GetContactCount()) return 0;
+
+	Dynamics::Contact contact = pW->GetContact(index - 1);
+
+	lua_pushinteger(L, contact.mObject + 1);// object
+	lua_pushinteger(L, contact.mOther + 1);	// object, other
+	lua_pushboolean(L, contact.mWall);	// object, other, bWall
+	PushVector(L, contact.mPoint);// object, other, bWall, (x y z)
+	PushVector(L, contact.mNormal);	// object, other, bWall, (x y z), (nx ny nz)
+
+	return 5;
+}
+
+static int WorldGetObjectCount (lua_State * L)
+{
+	lua_pushinteger(L, UW(L, 1)->GetObjectCount());
+
+	return 1;
+}
+
+static int WorldGetWallCount (lua_State * L)
+{
+	lua_pushinteger(L, UW(L, 1)->GetWallCount());
+
+	return 1;
+}
+
+static int WorldGetWorkerCount (lua_State * L)
+{
+	lua_pushinteger(L, UW(L, 1)->GetWorkerCount());
+
+	return 1;
+}
+
+static int WorldIsDeterministic (lua_State * L)
+{
+	lua_pushboolean(L, UW(L, 1)->IsDeterministic());
+
+	return 1;
+}
+
+/// @brief Plans shots, rescoring them with any cost function
+/// @return Count of results, or -1 if the cost function raised an error, which is left on the stack
+/// @note The candidates are kept in locals, so a cost function may plan shots itself; its errors
+///       are handed back rather than raised, so that the candidates are freed first
+static int PlanShots (lua_State * L)
+{
+	Dynamics::ShotQuery query;
+
+	query.mSphere = *UTT<Dynamics::Sphere>(L, 2);
+	query.mTarget = *UTT<Dynamics::Vector>(L, 3);
+	query.mForce = *UTT<Dynamics::Vector>(L, 4);
+	query.mType = Lua::U(L, 5);
+	query.mTime = Lua::F(L, 8);
+	query.mStep = Lua::F(L, 9);
+	query.mLimit = Lua::U(L, 10);
+	query.mRestitution = Lua::F(L, 11);
+	query.mEpsilon = Lua::F(L, 12);
+	query.mCeiling = Lua::F(L, 13);
+
+	size_t count = Lua::U(L, 14);
+
+	std::vector<float> speeds, angles;
+	std::vector<Dynamics::Shot> shots;
+
+	GetFloats(L, 6, speeds);
+	GetFloats(L, 7, angles);
+
+	UW(L, 1)->PlanShots(query, speeds.empty() ? 0 : &speeds[0], Lua::Uint(speeds.size()), angles.empty() ? 0 : &angles[0], Lua::Uint(angles.size()), shots);
+
+	Dynamics::Vector direction = (query.mTarget - query.mSphere.mCenter).XZ();
+
+	direction = direction * direction > 0.0f ? ~direction : Dynamics::Vector(0.0f, 0.0f, 1.0f);
+
+	// If a cost function was given, rescore the shots with it, dropping any it rejects.
+	if (lua_isfunction(L, 15))
+	{
+		size_t n = 0;
+
+		for (size_t i = 0; i < shots.size(); ++i)
+		{
+			lua_pushvalue(L, 15);	// ..., cost
+			PushShot(L, shots[i], direction);	// ..., cost, shot
+
+			if (lua_pcall(L, 1, 1, 0) != 0) return -1;	// ..., score
+
+			if (!lua_isnil(L, -1) && !lua_isboolean(L, -1))
+			{
+				shots[i].mCost = float(lua_tonumber(L, -1));
+				shots[n++] = shots[i];
+			}
+
+			lua_pop(L, 1);	// ...
+		}
+
+		shots.resize(n);
+	}
+
+	// Return the best shots.
+	count = std::min(count, shots.size());
+
+	std::partial_sort(shots.begin(), shots.begin() + count, shots.end());
+
+	lua_createtable(L, int(count), 0);	// ..., best
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		PushShot(L, shots[i], direction);	// ..., best, shot
+		lua_rawseti(L, -2, int(i + 1));	// ..., best = { ..., shot }
+	}
+
+	return 1;
+}
+
+// sphere: Object bounding sphere
+// target: Point to shoot at
+// force: Force applied to the object over unit time
+// type: Object material type
+// speeds, angles: Arrays of launch speeds and angles; every pair is a candidate
+// time, step, limit, restitution, epsilon: Prediction parameters, as for PredictPath
+// ceiling: Greatest height a shot may reach
+// count: Count of shots to return
+// cost: If present, function called with each shot, returning its cost, or nil to drop it
+// Returns an array of the best shots, by increasing cost
+// The cost function may itself plan shots, with this or another world
+static int WorldPlanShots (lua_State * L)
+{
+	int result = PlanShots(L);
+
+	if (result < 0) lua_error(L);
+
+	return result;
+}
+
+static int WorldPredictPath (lua_State * L)
+{
+	lua_pushinteger(L, UW(L, 1)->PredictPath(*UP(L, 2), *UTT<Dynamics::Sphere>(L, 3), *UTT<Dynamics::Vector>(L, 4), *UTT<Dynamics::Vector>(L, 5), Lua::U(L, 6), Lua::F(L, 7), Lua::F(L, 8), Lua::U(L, 9), Lua::F(L, 10), Lua::F(L, 11), Lua::F(L, 12)));
+
+	return 1;
+}
+
+static int WorldReplay (lua_State * L)
+{
+	Lua::Uint steps, mismatch;
+
+	lua_pushboolean(L, UW(L, 1)->Replay(Lua::S(L, 2), steps, mismatch));	// world, name, bOK
+	lua_pushinteger(L, steps);	// world, name, bOK, steps
+	lua_pushinteger(L, mismatch);	// world, name, bOK, steps, mismatch
+
+	return 3;
+}
+
+static int WorldSetDeterministic (lua_State * L)
+{
+	UW(L, 1)->SetDeterministic(Lua::B(L, 2));
+
+	return 0;
+}
+
+static int WorldSetMaterial (lua_State * L)
+{
+	UW(L, 1)->SetMaterial(Lua::U(L, 2), Lua::U(L, 3), Lua::B(L, 4));
+
+	return 0;
+}
+
+static int WorldSetWorkerCount (lua_State * L)
+{
+	// By default, use a thread per spare processor.
+	if (lua_isnoneornil(L, 2)) UW(L, 1)->SetWorkerCount(Dynamics::GetProcessorCount() - 1);
+
+	else UW(L, 1)->SetWorkerCount(Lua::U(L, 2));
+
+	return 0;
+}
+
+static int WorldStartLog (lua_State * L)
+{
+	lua_pushboolean(L, UW(L, 1)->StartLog(Lua::S(L, 2)));
+
+	return 1;
+}
+
+static int WorldStopLog (lua_State * L)
+{
+	UW(L, 1)->StopLog();
+
+	return 0;
+}
+
+///
+/// Wall tree functions
+///
+static int WallTreeAddQuad (lua_State * L)
+{
+	WallTree * pWT = UWT(L, 1);
+
+	pWT->mTree.Add(Dynamics::Box(*UTT<Dynamics::Quad>(L, 2)));
+	pWT->mIndices.push_back(luaL_optint(L, 3, int(pWT->mIndices.size()) + 1));
+
+	return 0;
+}
+
+static int WallTreeBuild (lua_State * L)
+{
+	UWT(L, 1)->mTree.Build();
+
+	return 0;
+}
+
+static int WallTreeClear (lua_State * L)
+{
+	WallTree * pWT = UWT(L, 1);
+
+	pWT->mTree.Clear();
+	pWT->mIndices.clear();
+
+	return 0;
+}
+
+static int WallTreeGetCount (lua_State * L)
+{
+	lua_pushinteger(L, UWT(L, 1)->mTree.GetCount());
+
+	return 1;
+}
+
+/// @brief Steps through the walls found by a query
+/// @note walls, wall: Walls found, linked from 0 in increasing order; previous wall
+static int WallTreeStep (lua_State * L)
+{
+	lua_rawget(L, 1);	// walls, wall'
+
+	return lua_isnil(L, 2) ? 0 : 1;
+}
+
+/// @brief Reads a vector field of an object
+/// @param index Stack index of object
+/// @param name Field name
+/// @return Vector, or zero vector if the field is absent
+static Dynamics::Vector FieldVector (lua_State * L, int index, char const * name)
+{
+	Dynamics::Vector vec(0.0f, 0.0f, 0.0f);
+
+	lua_getfield(L, index, name);	// ..., field
+
+	if (!lua_isnil(L, -1)) vec = *UTT<Dynamics::Vector>(L, -1);
+
+	lua_pop(L, 1);	// ...
+
+	return vec;
+}
+
+// object: Object whose position, motion, and radius are read
+// time: Time over which it moves
+// Returns a step function, the walls found, and 0, for use in a for loop
+// The walls and step function are upvalues, shared by every query, so each query's walls
+// must be stepped through before the next is made
+static int WallTreeIter (lua_State * L)
+{
+	WallTree * pWT = UWT(L, 1);
+
+	lua_settop(L, 3);	// tree, object, time
+
+	// Find the walls the object can reach over the time, ordered by index.
+	lua_getfield(L, 2, "GetRadius");// tree, object, time, GetRadius
+	lua_pushvalue(L, 2);// tree, object, time, GetRadius, object
+	lua_call(L, 1, 1);	// tree, object, time, radius
+
+	Dynamics::Sphere sphere(FieldVector(L, 2, "position"), Lua::F(L, 4));
+
+	std::vector<Lua::Uint> & found = pWT->mFound;
+
+	pWT->mTree.Query(Dynamics::Box(sphere, FieldVector(L, 2, "motion"), Lua::F(L, 3)), found);
+
+	for (size_t i = 0; i < found.size(); ++i) found[i] = Lua::Uint(pWT->mIndices[found[i]]);
+
+	std::sort(found.begin(), found.end());
+
+	found.erase(std::unique(found.begin(), found.end()), found.end());
+
+	// Link the walls in order, from 0 to the last one, which is linked to nil.
+	lua_pushvalue(L, lua_upvalueindex(2));	// tree, object, time, radius, step
+	lua_pushvalue(L, lua_upvalueindex(1));	// tree, object, time, radius, step, walls
+	lua_pushinteger(L, 0);	// tree, object, time, radius, step, walls, 0
+
+	for (size_t i = 0; i < found.size(); ++i)
+	{
+		lua_pushinteger(L, found[i]);	// tree, object, time, radius, step, walls, prev, wall
+		lua_pushvalue(L, -1);	// tree, object, time, radius, step, walls, prev, wall, wall
+		lua_insert(L, -3);	// tree, object, time, radius, step, walls, wall, prev, wall
+		lua_rawset(L, 6);	// tree, object, time, radius, step, walls = { ..., [prev] = wall }, wall
+	}
+
+	lua_pushnil(L);	// tree, object, time, radius, step, walls, last, nil
+	lua_rawset(L, 6);	// tree, object, time, radius, step, walls = { ..., [last] = nil }
+	lua_pushinteger(L, 0);	// tree, object, time, radius, step, walls, 0
+
+	return 3;
+}
+
+///
+/// Path functions
+///
+static int PathClear (lua_State * L)
+{
+	UP(L, 1)->mStates.clear();
+
+	return 0;
+}
+
+static int PathGetCount (lua_State * L)
+{
+	lua_pushinteger(L, UP(L, 1)->mStates.size());
+
+	return 1;
+}
+
+static int PathGetDuration (lua_State * L)
+{
+	Dynamics::Path * pP = UP(L, 1);
+
+	lua_pushnumber(L, pP->mStates.empty() ? 0.0f : pP->mStates.back().mTime);
+
+	return 1;
+}
+
+static int PathGetState (lua_State * L)
+{
+	Dynamics::Path * pP = UP(L, 1);
+
+	if (pP->mStates.empty()) return 0;
+
+	PushState(L, pP->GetState(Lua::F(L, 2)));	// path, time, state
+
+	return 1;
+}
+
+static int PathGetStates (lua_State * L)
+{
+	Dynamics::Path * pP = UP(L, 1);
+
+	lua_createtable(L, int(pP->mStates.size()), 0);	// path, states
+
+	for (size_t i = 0; i < pP->mStates.size(); ++i)
+	{
+		PushState(L, pP->mStates[i]);	// path, states, state
+		lua_pushnumber(L, pP->mStates[i].mTime);// path, states, state, time
+		lua_setfield(L, -2, "time");// path, states, state = { heading, motion, position, time = time }
+		lua_rawseti(L, -2, int(i + 1));	// path, states = { ..., state }
+	}
+
+	return 1;
+}
+
+///
+/// Shot functions
+///
+// Returns the launch motion
+static int ShotGetMotion (lua_State * L)
+{
+	ShotDatum * pSD = static_cast<ShotDatum*>(Lua::UD(L, 3));
+
+	Dynamics::Vector motion(pSD->mMotion);
+
+	PushVector(L, motion);// shot, key, datum, motion
+
+	return 1;
+}
+
+///
+/// Material registry functions
+///
+static int MaterialRegistryGetID (lua_State * L)
+{
+	lua_pushinteger(L, GetID(L, UMR(L, 1), 2));
+
+	return 1;
+}
+
+static int MaterialRegistryGetResponse (lua_State * L)
+{
+	MaterialRegistry * pMR = UMR(L, 1);
+
+	Lua::Uint id1 = Lua::U(L, 2), id2 = Lua::U(L, 3);
+
+	if (id1 >= pMR->mCount || id2 >= pMR->mCount) return 0;
+
+	int response = pMR->At(id1, id2);
+
+	if (0 == response) return 0;
+
+	lua_getfenv(L, 1);	// MR, id1, id2, E
+	lua_rawgeti(L, 4, eResponses);	// MR, id1, id2, E, responses
+	lua_rawgeti(L, 5, response);// MR, id1, id2, E, responses, response
+
+	return 1;
+}
+
+static int MaterialRegistryGetRevision (lua_State * L)
+{
+	lua_pushinteger(L, UMR(L, 1)->mRevision);
+
+	return 1;
+}
+
+static int MaterialRegistryLoad (lua_State * L)
+{
+	MaterialRegistry * pMR = UMR(L, 1);
+	Dynamics::World * pW = UW(L, 2);
+
+	// Responses apply to both object and wall pairs.
+	pW->ClearMaterials();
+
+	for (Lua::Uint i = 0; i < pMR->mPairs.size(); ++i)
+	{
+		pW->SetMaterial(pMR->mPairs[i].first, pMR->mPairs[i].second, false);
+		pW->SetMaterial(pMR->mPairs[i].first, pMR->mPairs[i].second, true);
+	}
+
+	return 0;
+}
+
+static int MaterialRegistryRegister (lua_State * L)
+{
+	MaterialRegistry * pMR = UMR(L, 1);
+
+	luaL_checktype(L, 4, LUA_TFUNCTION);
+
+	Lua::Uint id1 = GetID(L, pMR, 2), id2 = GetID(L, pMR, 3);
+
+	// Put the response in the pair's slot, adding one if the pair is new.
+	int & response = pMR->At(id1, id2);
+
+	lua_getfenv(L, 1);	// MR, type1, type2, response, E
+	lua_rawgeti(L, 5, eResponses);	// MR, type1, type2, response, E, responses
+
+	if (0 == response)
+	{
+		response = int(lua_objlen(L, 6)) + 1;
+
+		pMR->mPairs.push_back(std::make_pair(id1, id2));
+	}
+
+	lua_pushvalue(L, 4);// MR, type1, type2, response, E, responses, response
+	lua_rawseti(L, 6, response);// MR, type1, type2, response, E, responses = { ..., response }
+
+	++pMR->mRevision;
+
+	return 0;
+}
+
+///
+/// Garbage collectors
+///
+static int World__gc (lua_State * L)
+{
+	delete UW(L, 1);
+
+	return 0;
+}
+
+static int WallTree__gc (lua_State * L)
+{
+	delete UWT(L, 1);
+
+	return 0;
+}
+
+static int Path__gc (lua_State * L)
+{
+	delete UP(L, 1);
+
+	return 0;
+}
+
+static int MaterialRegistry__gc (lua_State * L)
+{
+	delete UMR(L, 1);
+
+	return 0;
+}
+
+///
+/// Function tables
+///
+#define M_(w) { #w, World##w }
+
+static const luaL_reg WorldFuncs[] = {
+	M_(__gc),
+	M_(AddObject),
+	M_(AddWall),
+	M_(ClearMaterials),
+	M_(ClearObjects),
+	M_(ClearWalls),
+	M_(FindHits),
+	M_(GetHit),
+	M_(GetObjectCount),
+	M_(GetWallCount),
+	M_(GetWorkerCount),
+	M_(IsDeterministic),
+	M_(PlanShots),
+	M_(PredictPath),
+	M_(Replay),
+	M_(SetDeterministic),
+	M_(SetMaterial),
+	M_(SetWorkerCount),
+	M_(StartLog),
+	M_(StopLog),
+	{ 0, 0 }
+};
+
+#undef M_
+
+#define M_(w) { #w, WallTree##w }
+
+static const luaL_reg WallTreeFuncs[] = {
+	M_(__gc),
+	M_(AddQuad),
+	M_(Build),
+	M_(Clear),
+	M_(GetCount),
+	{ 0, 0 }
+};
+
+#undef M_
+
+#define M_(w) { #w, Path##w }
+
+static const luaL_reg PathFuncs[] = {
+	M_(__gc),
+	M_(Clear),
+	M_(GetCount),
+	M_(GetDuration),
+	M_(GetState),
+	M_(GetStates),
+	{ 0, 0 }
+};
+
+#undef M_
+
+static const luaL_reg ShotGetters[] = {
+	{ "motion", ShotGetMotion },
+	{ 0, 0 }
+};
+
+#define M_(w) { #w, MaterialRegistry##w }
+
+static const luaL_reg MaterialRegistryFuncs[] = {
+	M_(__gc),
+	M_(GetID),
+	M_(GetResponse),
+	M_(GetRevision),
+	M_(Load),
+	M_(Register),
+	{ 0, 0 }
+};
+
+#undef M_
+
+///
+/// New functions
+///
+static int WorldNew (lua_State * L)
+{
+	Dynamics::World * pW = new Dynamics::World;
+
+	memcpy(Lua::UD(L, 1), &pW, sizeof(Dynamics::World*));
+
+	return 0;
+}
+
+static int WallTreeNew (lua_State * L)
+{
+	WallTree * pWT = new WallTree;
+
+	memcpy(Lua::UD(L, 1), &pWT, sizeof(WallTree*));
+
+	return 0;
+}
+
+static int PathNew (lua_State * L)
+{
+	Dynamics::Path * pP = new Dynamics::Path;
+
+	memcpy(Lua::UD(L, 1), &pP, sizeof(Dynamics::Path*));
+
+	return 0;
+}
+
+static int ShotNew (lua_State * L)
+{
+	memcpy(Lua::UD(L, 1), Lua::UD(L, 2), sizeof(ShotDatum));
+
+	return 0;
+}
+
+static int MaterialRegistryNew (lua_State * L)
+{
+	MaterialRegistry * pMR = new MaterialRegistry;
+
+	memcpy(Lua::UD(L, 1), &pMR, sizeof(MaterialRegistry*));
+
+	// Give the instance an environment to hold its IDs and responses.
+	lua_createtable(L, eResponses, 0);	// MR, E
+	lua_newtable(L);// MR, E, {}
+	lua_rawseti(L, -2, eIDs);	// MR, E = { ids }
+	lua_newtable(L);// MR, E, {}
+	lua_rawseti(L, -2, eResponses);	// MR, E = { ids, responses }
+	lua_setfenv(L, 1);	// MR
+
+	return 0;
+}
+
+/// @brief Binds the dynamics system to the Lua scripting system
+void luaopen_dynamics (lua_State * L)
+{
+	Lua::class_Define(L, "DynamicsPath", PathFuncs, PathNew, 0, sizeof(Dynamics::Path*));
+	Lua::class_Define(L, "DynamicsWorld", WorldFuncs, WorldNew, 0, sizeof(Dynamics::World*));
+	Lua::class_Define(L, "MaterialRegistry", MaterialRegistryFuncs, MaterialRegistryNew, 0, sizeof(MaterialRegistry*));
+
+	// Wall tree queries share one set of walls and one step function, held by Iter.
+	char const * iter[] = { "Iter" };
+
+	lua_newtable(L);// walls
+	lua_pushcfunction(L, WallTreeStep);	// walls, step
+	lua_pushcclosure(L, WallTreeIter, 2);	// Iter
+	Lua::class_Define(L, "WallTree", WallTreeFuncs, iter, 1, WallTreeNew, 0, sizeof(WallTree*));
+
+	// Shots are read through their members, which are kept in the instance memory.
+	Lua::Member_Reg members[7];
+
+	members[0].Set(offsetof(Dynamics::Shot, mAngle), "angle", Lua::Member_Reg::eFSingle);
+	members[1].Set(offsetof(Dynamics::Shot, mBounces), "bounces", Lua::Member_Reg::eUInt);
+	members[2].Set(offsetof(Dynamics::Shot, mCost), "cost", Lua::Member_Reg::eFSingle);
+	members[3].Set(offsetof(Dynamics::Shot, mDistance), "distance", Lua::Member_Reg::eFSingle);
+	members[4].Set(offsetof(Dynamics::Shot, mPeak), "peak", Lua::Member_Reg::eFSingle);
+	members[5].Set(offsetof(Dynamics::Shot, mSpeed), "speed", Lua::Member_Reg::eFSingle);
+	members[6].Set(offsetof(Dynamics::Shot, mTime), "time", Lua::Member_Reg::eFSingle);
+
+	int count = sizeof(members) / sizeof(members[0]);
+
+	for (int index = 0; index < count; ++index) members[index].mPermissions = Lua::Member_Reg::eRO;
+
+	char const * closures[] = { "__index", "__newindex" };
+
+	Lua::MemberBindFuncs(L, ShotGetters, 0, members, count, Lua::eThis);	// __index, __newindex
+	Lua::class_Define(L, "DynamicsShot", 0, closures, 2, ShotNew, 0, sizeof(ShotDatum));
+}
\ No newline at end of file
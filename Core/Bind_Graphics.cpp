@@ -79,11 +79,11 @@ template<typename T> static int UT_I4 (lua_State * L, int (*func)(T *, int, int,
 	return 0;
 }
 
-template<typename T> static int Load (lua_State * L, std::string const & name, T datum)
+template<typename T> static int Load (lua_State * L, char const * name, T datum)
 {
 	if (datum != 0)
 	{
-		Lua::PushUserType(L, datum, name.c_str());
+		Lua::PushUserType(L, datum, name);
 
 		return 1;
 	}
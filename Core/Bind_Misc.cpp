@@ -1,56 +1,84 @@
 #include "App.h"
+#include "Dynamics.h"
+#include "Trajectory.h"
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
-/// @brief Hit storage
-struct Hit {
-	Lua::AppTypes::Vector mContact;	///< Point of collision contact
-	Lua::AppTypes::Vector mNormal;	///< Normal at collision point
-	float mT;	///< Time of hit
-	bool mInit;	///< Initialization flag
+/// @brief Most vectors kept for reuse
+static const int PoolSize = 256;
 
-	// Methods
-	Hit (float fLimit) : mT(fLimit), mInit(false) {};
+///
+/// Vector handlers
+///
+/// @brief Points to a vector argument
+/// @note The Vector metatable is upvalue 1 of the functions in this file, so vectors are
+///       recognized without a registry lookup
+static Lua::AppTypes::Vector * PV_ (lua_State * L, int index)
+{
+	void * data = lua_touserdata(L, index);
 
-	void AddHit (Lua::AppTypes::Vector const & contact, Lua::AppTypes::Vector const & normal, float fT);
-	int LoadHit (lua_State * L);
-};
+	// Accept vectors directly; leave anything else to the general handler.
+	if (data != 0 && lua_getmetatable(L, index))
+	{
+		bool bVector = lua_rawequal(L, -1, lua_upvalueindex(1)) != 0;
 
-static bool _BQF (float a, float b, float c, float & t)
-{
-	if (fabsf(a) < 1e-6f) return false;
+		lua_pop(L, 1);
 
-	float term = b * b - a * c;
+		if (bVector) return static_cast<Lua::AppTypes::Vector*>(data);
+	}
 
-	if (term < 0.0f) return false;
+	return static_cast<Lua::AppTypes::Vector*>(Lua::UT(L, index));
+}
 
-	float discriminant = sqrtf(term);
+/// @brief Pushes a vector onto the stack
+/// @note Upvalue 2 is a pool of recycled vectors, kept both as an array and as keys, so
+///       that none is pooled twice; if the pool is empty, a new vector is made
+/// @note Without a pool, the vector type is looked up on first use and kept
+static void PushVector (lua_State * L, Lua::AppTypes::Vector const & v)
+{
+	if (!lua_istable(L, lua_upvalueindex(1)))
+	{
+		static Lua::UserType * spVector;
 
-	t = (-b - discriminant) / a;
+		if (0 == spVector) spVector = Lua::GetUserType(L, "Vector");
 
-	if (t < 0.0f) t = (-b + discriminant) / a;
+		Lua::PushUserType(L, const_cast<Lua::AppTypes::Vector*>(&v), spVector);
 
-	return t >= 0.0f;
-}
+		return;
+	}
 
-void Hit::AddHit (Lua::AppTypes::Vector const & contact, Lua::AppTypes::Vector const & normal, float fT)
-{
-	if (fT >= mT) return;
+	// Reuse a pooled vector if possible. Otherwise, make a new one.
+	int count = int(lua_objlen(L, lua_upvalueindex(2)));
 
-	mContact = contact;
-	mNormal = normal;
-	mT = fT;
+	if (count > 0)
+	{
+		lua_rawgeti(L, lua_upvalueindex(2), count);	// ..., v
+		lua_pushnil(L);	// ..., v, nil
+		lua_rawseti(L, lua_upvalueindex(2), count);	// ..., v
+		lua_pushvalue(L, -1);	// ..., v, v
+		lua_pushnil(L);	// ..., v, v, nil
+		lua_rawset(L, lua_upvalueindex(2));	// ..., v
+	}
+
+	else
+	{
+		lua_newuserdata(L, sizeof(Lua::AppTypes::Vector));	// ..., v
+		lua_pushvalue(L, lua_upvalueindex(1));	// ..., v, mt
+		lua_setmetatable(L, -2);// ..., v
+	}
 
-	mInit = true;
+	*static_cast<Lua::AppTypes::Vector*>(lua_touserdata(L, -1)) = v;
 }
 
-int Hit::LoadHit (lua_State * L)
+/// @brief Loads a hit onto the stack
+static int LoadHit (lua_State * L, Dynamics::Hit const & hit)
 {
-	if (!mInit) return 0;
+	if (!hit.mInit) return 0;
 
-	lua_pushnumber(L, mT);	// t
-	Lua::PushUserType(L, &mContact, "Vector");	// t (x y z)
-	Lua::PushUserType(L, &(~mNormal), "Vector");// t (x y z) (nx ny nz)
+	lua_pushnumber(L, hit.mT);	// t
+	PushVector(L, hit.mContact);	// t (x y z)
+	PushVector(L, hit.mNormal);	// t (x y z) (nx ny nz)
 
 	return 3;
 }
@@ -76,7 +104,7 @@ static inline Lua::AppTypes::Quad * UQ_ (lua_State * L, int index)
 
 static inline Lua::AppTypes::Vector UV_ (lua_State * L, int index)
 {
-	return (*UTT<Lua::AppTypes::Vector>(L, index));
+	return *PV_(L, index);
 }
 
 ///
@@ -86,7 +114,7 @@ static int Reflect (lua_State * L)
 {
 	Lua::AppTypes::Vector N = UV_(L, 1), I = UV_(L, 2);
 
-	Lua::PushUserType(L, &(I - 2.0f * (N * I) * N), "Vector");
+	PushVector(L, I - 2.0f * (N * I) * N);
 
 	return 1;
 }
@@ -105,7 +133,7 @@ static int Slide (lua_State * L)
 
 	if (fVN > 0.0f && fVN <= 0.5f * Lua::F(L, 4) * Lua::F(L, 3) * sqrtf(1.0f - T.m[1] * T.m[1]))
 	{
-		Lua::PushUserType(L, &Lua::AppTypes::Vector(T.m[0], 0.0f, T.m[2]), "Vector");
+		PushVector(L, Lua::AppTypes::Vector(T.m[0], 0.0f, T.m[2]));
 
 		return 1;
 	}
@@ -115,120 +143,21 @@ static int Slide (lua_State * L)
 
 static int SphereQuad (lua_State * L)
 {
-	float fLimit = Lua::F(L, 4);
-
-	Hit hit(fLimit);
-
-	Lua::AppTypes::Sphere * pS = US_(L, 1);
-	Lua::AppTypes::Quad * pQ = UQ_(L, 2);
-
-	Lua::AppTypes::Vector V = UV_(L, 3), N = pQ->mNormal, P = pQ->mCorners[0];
-
-	// Switch the normal's sense if the sphere is on the opposite side of the quad.
-	Lua::AppTypes::Vector D = pS->mCenter - P;
-
-	if (D * N < 0.0f) N = -N;
-
-	// If the sphere's motion is parallel to / away from the plane, or will not switch
-	// sides before hitting its goal, trivially reject it if it is not near the plane.
-	float fDN = D * N, fVN = V * N;
-
-	bool bPlaneHit = fVN < -1e-6f;
-
-	if (!bPlaneHit && fDN > pS->mRadius + 1e-3f) return 0;
-	if (fDN + fLimit * fVN > pS->mRadius + 1e-3f) return 0;
-
-	// Determine if and when the sphere will intersect the quad plane in this step. If the
-	// sphere is penetrating or touching, this is instant.
-	float fT = bPlaneHit && pS->mRadius < fDN ? (pS->mRadius - fDN) / fVN : 0.0f;
-
-	bPlaneHit &= fT >= 0.0f;
-
-	float fV2 = V * V, fR2 = pS->mRadius * pS->mRadius;
-
-	// If there is nothing to test, quit now.
-	if (!bPlaneHit && pQ->mETest.none() && pQ->mVTest.none()) return 0;
-
-	// Move the center along its heading up to the collision time. From here, step from the
-	// center to the point of intersection on the sphere.
-	Lua::AppTypes::Vector C = pS->mCenter + fT * V - pS->mRadius * N;
-
-	// Iterate through the four corners, forming an edge with the corner prior to each.
-	for (Uint32 index = 0; index < 4; ++index)
-	{
-		Lua::AppTypes::Vector Q = pQ->mCorners[(index + 1) % 4];
-		Lua::AppTypes::Vector edge = Q - P;
-
-		// Form a ray from the corner to the point on the plane.  If its cross product with
-		// the edge points away from the surface normal, the point is outside the quad.
-		bPlaneHit &= ((Q - C) ^ edge) * N > 0.0f;
-
-		// Test the sphere against the current edge.
-		float fDV = D * V, fD2 = D * D, fT;
-
-		if (pQ->mETest[index])
-		{
-			Lua::AppTypes::Vector EU = ~edge;
+	Dynamics::Hit hit(Lua::F(L, 4));
 
-			float fEV = EU * V, fED = EU * D;
-
-			if (_BQF(fV2 - fEV * fEV, V * D - fED * fEV, fD2 - fED * fED - fR2, fT))
-			{
-				Lua::AppTypes::Vector C = pS->mCenter + fT * V;
-
-				float fOffset = (C - P) * EU;
-
-				// Verify that the contact lies along the edge.
-				if (fOffset > 0.0f && fOffset < edge.length())
-				{
-					Lua::AppTypes::Vector contact = P + fOffset * EU;
-
-					hit.AddHit(contact, C - contact, fT);
-				}
-			}
-		}
-
-		// Test the sphere against the current vertex.
-		if (pQ->mVTest[index] && _BQF(fV2, fDV, fD2 - fR2, fT)) hit.AddHit(P, D + fT * V, fT);
-
-		P = Q;
-		D = pS->mCenter - P;
-	}
-
-	// Load the point on the plane if it lies within the quad.
-	if (bPlaneHit) hit.AddHit(C, N, fT);
+	Dynamics::SphereQuad(*US_(L, 1), *UQ_(L, 2), UV_(L, 3), hit);
 
 	// Return the first hit.
-	return hit.LoadHit(L);
+	return LoadHit(L, hit);
 }
 
 static int Spheres (lua_State * L)
 {
-	// Compute the coefficients for the sphere collision equation, which is a binary
-	// quadratic form. Check whether the spheres will intersect in this time step.
-	Lua::AppTypes::Sphere * pS1 = US_(L, 1), * pS2 = US_(L, 2);
-
-	Lua::AppTypes::Vector V1 = UV_(L, 3), V2 = UV_(L, 4);
-
-	Lua::AppTypes::Vector dC = pS1->mCenter - pS2->mCenter, dV = V1 - V2;
-
-	float fT, rSum = pS1->mRadius + pS2->mRadius;
-
-	if (_BQF(dV * dV, dV * dC, dC * dC - rSum * rSum, fT) && fT < Lua::F(L, 5))
-	{
-		lua_pushnumber(L, fT);	// t
+	Dynamics::Hit hit(Lua::F(L, 5));
 
-		// Compute the vector between the new centers, following it to the collision point.
-		// Normalize it to acquire the collision normal.
-		dC = pS1->mRadius / rSum * (dC + fT * dV);
+	Dynamics::Spheres(*US_(L, 1), *US_(L, 2), UV_(L, 3), UV_(L, 4), hit);
 
-		Lua::PushUserType(L, &(pS1->mCenter + fT * V1 - dC), "Vector");	// t (x y z)
-		Lua::PushUserType(L, &(dC / pS1->mRadius), "Vector");// t (x y z) (nx ny nz)
-
-		return 3;
-	}
-
-	return 0;
+	return LoadHit(L, hit);
 }
 
 ///
@@ -238,7 +167,7 @@ static int BQF (lua_State * L)
 {
 	float t;
 
-	if (_BQF(Lua::F(L, 1), Lua::F(L, 2), Lua::F(L, 3), t))
+	if (Dynamics::BQF(Lua::F(L, 1), Lua::F(L, 2), Lua::F(L, 3), t))
 	{
 		lua_pushnumber(L, t);
 
@@ -264,28 +193,28 @@ static int Sphere (lua_State * L)
 
 static int Vector (lua_State * L)
 {
-	Lua::PushUserType(L, &Lua::AppTypes::Vector(Lua::F(L, 1), Lua::F(L, 2), Lua::F(L, 3)), "Vector");
+	PushVector(L, Lua::AppTypes::Vector(Lua::F(L, 1), Lua::F(L, 2), Lua::F(L, 3)));
 
 	return 1;
 }
 
 static int vXZ (lua_State * L)
 {
-	Lua::PushUserType(L, &Lua::AppTypes::Vector(Lua::F(L, 1), 0.0f, Lua::F(L, 2)), "Vector");
+	PushVector(L, Lua::AppTypes::Vector(Lua::F(L, 1), 0.0f, Lua::F(L, 2)));
 
 	return 1;
 }
 
 static int vY (lua_State * L)
 {
-	Lua::PushUserType(L, &Lua::AppTypes::Vector(0.0f, Lua::F(L, 1), 0.0f), "Vector");
+	PushVector(L, Lua::AppTypes::Vector(0.0f, Lua::F(L, 1), 0.0f));
 
 	return 1;
 }
 
 static int v0 (lua_State * L)
 {
-	Lua::PushUserType(L, &Lua::AppTypes::Vector(0.0f, 0.0f, 0.0f), "Vector");
+	PushVector(L, Lua::AppTypes::Vector(0.0f, 0.0f, 0.0f));
 
 	return 1;
 }
@@ -531,7 +460,7 @@ static int GetPosition (lua_State * L)
 	Lua::AppTypes::Vector vT = ~(UV_(L, 2) - begin).XZ() * fV * sqrtf(1.0f - fSin * fSin);
 	Lua::AppTypes::Vector vN = _Y(fV * fSin - 0.5f * fG * fT);
 
-	Lua::PushUserType(L, &(begin + fT * (vT + vN)), "Vector");
+	PushVector(L, begin + fT * (vT + vN));
 
 	return 1;
 }
@@ -605,7 +534,140 @@ static int GetVelocity (lua_State * L)
 	Lua::AppTypes::Vector vT = ~(UV_(L, 2) - UV_(L, 1)).XZ() * fV * sqrtf(1.0f - fSin * fSin);
 	Lua::AppTypes::Vector vN = _Y(fV * fSin - fG * fT);
 
-	Lua::PushUserType(L, &(vT + vN), "Vector");
+	PushVector(L, vT + vN);
+
+	return 1;
+}
+
+/// @brief Reads a vector from a field of a table
+/// @param index Stack index of table
+/// @param name Field name
+/// @return Vector
+static Lua::AppTypes::Vector GetField (lua_State * L, int index, char const * name)
+{
+	lua_getfield(L, index, name);	// ..., v
+
+	Lua::AppTypes::Vector v = UV_(L, -1);
+
+	lua_pop(L, 1);	// ...
+
+	return v;
+}
+
+/// @brief Appends a number to an array
+/// @param index Stack index of array
+/// @param count [in-out] Count of numbers in the array
+/// @param fValue Value to append
+static void Append (lua_State * L, int index, int & count, float fValue)
+{
+	lua_pushnumber(L, fValue);	// ..., value
+	lua_rawseti(L, index, ++count);	// ...
+}
+
+// path: Array of states, each with position and motion, bounding consecutive curves
+// heights: Array of heights of interest
+// p: Current position, along the first curve
+// y: Current height
+// g: Gravity force
+// side: If present, normal of the side to keep; intercepts behind it are dropped
+static int GetIntercepts (lua_State * L)
+{
+	float fY = Lua::F(L, 4), fG = Lua::F(L, 5);
+
+	bool bSide = !lua_isnoneornil(L, 6);
+
+	Lua::AppTypes::Vector side = bSide ? UV_(L, 6) : Lua::AppTypes::Vector();
+
+	int count = int(lua_objlen(L, 1)), nheights = int(lua_objlen(L, 2)), nvalues = 0;
+
+	lua_settop(L, 6);
+	lua_newtable(L);// path, heights, p, y, g, side, intercepts
+
+	if (0 == count || fG <= 0.0f) return 1;
+
+	// Determine how long was already spent along the first curve. This will be the minimum
+	// time. Intercepts are timed from here.
+	lua_rawgeti(L, 1, 1);	// path, heights, p, y, g, side, intercepts, state
+
+	Lua::AppTypes::Vector P = GetField(L, 8, "position"), M = GetField(L, 8, "motion");
+
+	float fTime = 0.0f, fV = M.length(), fA = M.angle();
+
+	if (fV > 0.0f && fA > -fHalfPi && fA < +fHalfPi) fTime = -(UV_(L, 3) - P).XZ().length() / (fV * cosf(fA));
+
+	lua_pop(L, 1);	// path, heights, p, y, g, side, intercepts
+
+	// Run through the curves. Determine the time span needed to cover each curve, and when in
+	// this span the curve reaches the heights of interest, ignoring any before the minimum
+	// time. Pack each of these found on the side as the height index, time, position, and
+	// velocity.
+	for (int index = 1; index < count; ++index)
+	{
+		lua_rawgeti(L, 1, index + 1);	// path, heights, p, y, g, side, intercepts, next
+
+		Lua::AppTypes::Vector Q = GetField(L, 8, "position"), N = GetField(L, 8, "motion"), diff = Q - P;
+
+		float fSpan = 0.0f;
+
+		fV = M.length();
+		fA = M.angle();
+
+		if (fV > 0.0f && fA > -fHalfPi && fA < +fHalfPi)
+		{
+			fSpan = diff.XZ().length() / (fV * cosf(fA));
+
+			float fSin = sinf(fA), fB = fV * fSin;
+
+			Lua::AppTypes::Vector vT = ~diff.XZ() * fV * sqrtf(1.0f - fSin * fSin);
+
+			for (int which = 1; which <= nheights; ++which)
+			{
+				lua_rawgeti(L, 2, which);	// path, heights, p, y, g, side, intercepts, next, h
+
+				float fTerm = fB * fB - 2.0f * fG * (float(lua_tonumber(L, -1)) - fY);
+
+				lua_pop(L, 1);	// path, heights, p, y, g, side, intercepts, next
+
+				if (fTerm < 0.0f) continue;
+
+				fTerm = sqrtf(fTerm);
+
+				// Take the lesser and greater times at which the curve reaches the height.
+				for (int k = 0; k < 2; ++k)
+				{
+					fTerm = -fTerm;
+
+					if (fB < -fTerm) continue;
+
+					float fT = (fB + fTerm) / fG;
+
+					if (fT <= -fTime || fT >= fSpan) continue;
+
+					Lua::AppTypes::Vector position = P + fT * (vT + _Y(fB - 0.5f * fG * fT));
+
+					if (bSide && position * side < 0.0f) continue;
+
+					Lua::AppTypes::Vector velocity = vT + _Y(fB - fG * fT);
+
+					Append(L, 7, nvalues, float(which));
+					Append(L, 7, nvalues, fTime + fT);
+
+					for (int c = 0; c < 3; ++c) Append(L, 7, nvalues, position.m[c]);
+					for (int c = 0; c < 3; ++c) Append(L, 7, nvalues, velocity.m[c]);
+				}
+			}
+		}
+
+		lua_pop(L, 1);	// path, heights, p, y, g, side, intercepts
+
+		// Go to the next curve. Advance the time by the span of the current curve. Elevate
+		// the starting height.
+		fTime += fSpan;
+		fY += diff.m[1];
+
+		P = Q;
+		M = N;
+	}
 
 	return 1;
 }
@@ -653,12 +715,220 @@ static int GetYTimes (lua_State * L)
 	return count;
 }
 
+/// @brief Reads an array of numbers into a buffer
+/// @param index Stack index of array
+/// @param buffer [out] Buffer to fill
+/// @return Count of numbers read
+static Uint32 ReadArray (lua_State * L, int index, std::vector<float> & buffer)
+{
+	Uint32 count = Uint32(lua_objlen(L, index));
+
+	buffer.resize(count + 1);
+
+	for (Uint32 i = 0; i < count; ++i)
+	{
+		lua_rawgeti(L, index, int(i + 1));	// ..., value
+
+		buffer[i] = float(lua_tonumber(L, -1));
+
+		lua_pop(L, 1);	// ...
+	}
+
+	return count;
+}
+
+/// @brief Pushes an array of batch results
+/// @param values Results, with Trajectory::fNone where there is no solution
+/// @param count Count of results
+/// @note Results without a solution are given as false, so the array has no holes
+static void PushArray (lua_State * L, float const * values, Uint32 count)
+{
+	lua_createtable(L, int(count), 0);	// ..., array
+
+	for (Uint32 i = 0; i < count; ++i)
+	{
+		if (!Trajectory::IsNone(values[i])) lua_pushnumber(L, values[i]);	// ..., array, value
+
+		else lua_pushboolean(L, false);	// ..., array, false
+
+		lua_rawseti(L, -2, int(i + 1));	// ..., array
+	}
+}
+
+/// @brief Pushes an array of batch result vectors
+/// @param x, y, z Result components, with Trajectory::fNone where there is no solution
+/// @param count Count of results
+static void PushVectorArray (lua_State * L, float const * x, float const * y, float const * z, Uint32 count)
+{
+	lua_createtable(L, int(count), 0);	// ..., array
+
+	for (Uint32 i = 0; i < count; ++i)
+	{
+		if (!Trajectory::IsNone(x[i])) PushVector(L, Lua::AppTypes::Vector(x[i], y[i], z[i]));	// ..., array, v
+
+		else lua_pushboolean(L, false);	// ..., array, false
+
+		lua_rawseti(L, -2, int(i + 1));	// ..., array
+	}
+}
+
+/// @brief Buffers shared by the batch functions
+static std::vector<float> sIn[2], sOut[3];
+
+// x, y: Target point
+// speeds: Array of initial speeds
+// g: Gravity force
+// Returns arrays of lesser and greater angles, with false where there are fewer
+static int GetAnglesBatch (lua_State * L)
+{
+	Uint32 count = ReadArray(L, 3, sIn[0]);
+
+	sOut[0].resize(count + 1);
+	sOut[1].resize(count + 1);
+
+	Trajectory::GetAngles(Lua::F(L, 1), Lua::F(L, 2), &sIn[0][0], Lua::F(L, 4), count, &sOut[0][0], &sOut[1][0]);
+
+	PushArray(L, &sOut[0][0], count);
+	PushArray(L, &sOut[1][0], count);
+
+	return 2;
+}
+
+// speeds: Array of initial speeds
+// angles: Array of launch angles
+// g: Gravity force
+static int GetMaxHeightBatch (lua_State * L)
+{
+	Uint32 count = std::min(ReadArray(L, 1, sIn[0]), ReadArray(L, 2, sIn[1]));
+
+	sOut[0].resize(count + 1);
+
+	Trajectory::GetMaxHeights(&sIn[0][0], &sIn[1][0], Lua::F(L, 3), count, &sOut[0][0]);
+
+	PushArray(L, &sOut[0][0], count);
+
+	return 1;
+}
+
+// begin, end: Trajectory curve bounds
+// speeds: Array of initial speeds
+// angles: Array of launch angles
+// g: Gravity force
+// t: Time along curves
+static int GetPositionBatch (lua_State * L)
+{
+	Uint32 count = std::min(ReadArray(L, 3, sIn[0]), ReadArray(L, 4, sIn[1]));
+
+	for (int i = 0; i < 3; ++i) sOut[i].resize(count + 1);
+
+	Trajectory::GetPositions(UV_(L, 1), UV_(L, 2), &sIn[0][0], &sIn[1][0], Lua::F(L, 5), Lua::F(L, 6), count, &sOut[0][0], &sOut[1][0], &sOut[2][0]);
+
+	PushVectorArray(L, &sOut[0][0], &sOut[1][0], &sOut[2][0], count);
+
+	return 1;
+}
+
+// x, y: Target point
+// angles: Array of launch angles
+// g: Gravity force
+static int GetSpeedBatch (lua_State * L)
+{
+	Uint32 count = ReadArray(L, 3, sIn[0]);
+
+	sOut[0].resize(count + 1);
+
+	Trajectory::GetSpeeds(Lua::F(L, 1), Lua::F(L, 2), &sIn[0][0], Lua::F(L, 4), count, &sOut[0][0]);
+
+	PushArray(L, &sOut[0][0], count);
+
+	return 1;
+}
+
+// x: Tangential distance along curves
+// speeds: Array of initial speeds
+// angles: Array of launch angles
+static int GetTimeBatch (lua_State * L)
+{
+	Uint32 count = std::min(ReadArray(L, 2, sIn[0]), ReadArray(L, 3, sIn[1]));
+
+	sOut[0].resize(count + 1);
+
+	Trajectory::GetTimes(Lua::F(L, 1), &sIn[0][0], &sIn[1][0], count, &sOut[0][0]);
+
+	PushArray(L, &sOut[0][0], count);
+
+	return 1;
+}
+
+// begin, end: Trajectory curve bounds
+// speeds: Array of initial speeds
+// angles: Array of launch angles
+// g: Gravity force
+// t: Time along curves
+static int GetVelocityBatch (lua_State * L)
+{
+	Uint32 count = std::min(ReadArray(L, 3, sIn[0]), ReadArray(L, 4, sIn[1]));
+
+	for (int i = 0; i < 3; ++i) sOut[i].resize(count + 1);
+
+	Trajectory::GetVelocities(UV_(L, 1), UV_(L, 2), &sIn[0][0], &sIn[1][0], Lua::F(L, 5), Lua::F(L, 6), count, &sOut[0][0], &sOut[1][0], &sOut[2][0]);
+
+	PushVectorArray(L, &sOut[0][0], &sOut[1][0], &sOut[2][0], count);
+
+	return 1;
+}
+
+// y: Normal distance along curves
+// speeds: Array of initial speeds
+// angles: Array of launch angles
+// g: Gravity force
+// Returns arrays of lesser and greater times, with false where there are fewer
+static int GetYTimesBatch (lua_State * L)
+{
+	Uint32 count = std::min(ReadArray(L, 2, sIn[0]), ReadArray(L, 3, sIn[1]));
+
+	sOut[0].resize(count + 1);
+	sOut[1].resize(count + 1);
+
+	Trajectory::GetYTimes(Lua::F(L, 1), &sIn[0][0], &sIn[1][0], Lua::F(L, 4), count, &sOut[0][0], &sOut[1][0]);
+
+	PushArray(L, &sOut[0][0], count);
+	PushArray(L, &sOut[1][0], count);
+
+	return 2;
+}
+
 ///
 /// Vector
 ///
 static int Add (lua_State * L)
 {
-	Lua::PushUserType(L, &(UV_(L, 1) + UV_(L, 2)), "Vector");
+	PushVector(L, UV_(L, 1) + UV_(L, 2));
+
+	return 1;
+}
+
+static int AddScaled (lua_State * L)
+{
+	PushVector(L, UV_(L, 1) + UV_(L, 2) * Lua::F(L, 3));
+
+	return 1;
+}
+
+static int AddScaledTo (lua_State * L)
+{
+	*PV_(L, 1) = UV_(L, 2) + UV_(L, 3) * Lua::F(L, 4);
+
+	lua_settop(L, 1);
+
+	return 1;
+}
+
+static int AddTo (lua_State * L)
+{
+	*PV_(L, 1) = UV_(L, 2) + UV_(L, 3);
+
+	lua_settop(L, 1);
 
 	return 1;
 }
@@ -676,28 +946,55 @@ static int ClampToMax (lua_State * L)
 
 	float fMax = Lua::F(L, 2);
 
-	Lua::PushUserType(L, &(V.length() > fMax ? fMax * ~V : V), "Vector");
+	PushVector(L, V.length() > fMax ? fMax * ~V : V);
 
 	return 1;
 }
 
 static int Copy (lua_State * L)
 {
-	Lua::PushUserType(L, &Lua::AppTypes::Vector(UV_(L, 1)), "Vector");
+	PushVector(L, *PV_(L, 1));
+
+	return 1;
+}
+
+static int CopyTo (lua_State * L)
+{
+	*PV_(L, 1) = UV_(L, 2);
+
+	lua_settop(L, 1);
 
 	return 1;
 }
 
 static int Cross (lua_State * L)
 {
-	Lua::PushUserType(L, &(UV_(L, 1) ^ UV_(L, 2)), "Vector");
+	PushVector(L, UV_(L, 1) ^ UV_(L, 2));
+
+	return 1;
+}
+
+static int CrossTo (lua_State * L)
+{
+	*PV_(L, 1) = UV_(L, 2) ^ UV_(L, 3);
+
+	lua_settop(L, 1);
 
 	return 1;
 }
 
 static int Div (lua_State * L)
 {
-	Lua::PushUserType(L, &(UV_(L, 1) / Lua::F(L, 2)), "Vector");
+	PushVector(L, UV_(L, 1) / Lua::F(L, 2));
+
+	return 1;
+}
+
+static int DivTo (lua_State * L)
+{
+	*PV_(L, 1) = UV_(L, 2) / Lua::F(L, 3);
+
+	lua_settop(L, 1);
 
 	return 1;
 }
@@ -711,23 +1008,78 @@ static int Len (lua_State * L)
 
 static int Mul (lua_State * L)
 {
-	if (lua_isnumber(L, 2)) Lua::PushUserType(L, &(UV_(L, 1) * Lua::F(L, 2)), "Vector");
+	if (lua_isnumber(L, 2)) PushVector(L, UV_(L, 1) * Lua::F(L, 2));
 
 	else lua_pushnumber(L, UV_(L, 1) * UV_(L, 2));
 
 	return 1;
 }
 
+static int MulTo (lua_State * L)
+{
+	*PV_(L, 1) = UV_(L, 2) * Lua::F(L, 3);
+
+	lua_settop(L, 1);
+
+	return 1;
+}
+
 static int Neg (lua_State * L)
 {
-	Lua::PushUserType(L, &(-UV_(L, 1)), "Vector");
+	PushVector(L, -UV_(L, 1));
 
 	return 1;
 }
 
+static int NegTo (lua_State * L)
+{
+	*PV_(L, 1) = -UV_(L, 2);
+
+	lua_settop(L, 1);
+
+	return 1;
+}
+
+static int Recycle (lua_State * L)
+{
+	// Pool each vector that is not already pooled, while there is room.
+	for (int index = 1, top = lua_gettop(L); index <= top; ++index)
+	{
+		if (int(lua_objlen(L, lua_upvalueindex(2))) >= PoolSize) break;
+
+		PV_(L, index);
+
+		lua_pushvalue(L, index);// ..., v
+		lua_rawget(L, lua_upvalueindex(2));	// ..., bPooled
+
+		bool bPooled = lua_toboolean(L, -1) != 0;
+
+		lua_pop(L, 1);	// ...
+
+		if (bPooled) continue;
+
+		lua_pushvalue(L, index);// ..., v
+		lua_pushboolean(L, true);	// ..., v, true
+		lua_rawset(L, lua_upvalueindex(2));	// ...
+		lua_pushvalue(L, index);// ..., v
+		lua_rawseti(L, lua_upvalueindex(2), int(lua_objlen(L, lua_upvalueindex(2))) + 1);	// ...
+	}
+
+	return 0;
+}
+
 static int ScaleTo (lua_State * L)
 {
-	Lua::PushUserType(L, &(~UV_(L, 1) * Lua::F(L, 2)), "Vector");
+	PushVector(L, ~UV_(L, 1) * Lua::F(L, 2));
+
+	return 1;
+}
+
+static int Set (lua_State * L)
+{
+	*PV_(L, 1) = Lua::AppTypes::Vector(Lua::F(L, 2), Lua::F(L, 3), Lua::F(L, 4));
+
+	lua_settop(L, 1);
 
 	return 1;
 }
@@ -736,14 +1088,23 @@ static int SphereInvert (lua_State * L)
 {
 	Lua::AppTypes::Vector V = UV_(L, 1);
 
-	Lua::PushUserType(L, &(V / (V * V)), "Vector");
+	PushVector(L, V / (V * V));
 
 	return 1;
 }
 
 static int Sub (lua_State * L)
 {
-	Lua::PushUserType(L, &(UV_(L, 1) - UV_(L, 2)), "Vector");
+	PushVector(L, UV_(L, 1) - UV_(L, 2));
+
+	return 1;
+}
+
+static int SubTo (lua_State * L)
+{
+	*PV_(L, 1) = UV_(L, 2) - UV_(L, 3);
+
+	lua_settop(L, 1);
 
 	return 1;
 }
@@ -759,28 +1120,37 @@ static int TLen (lua_State * L)
 
 static int Unit (lua_State * L)
 {
-	Lua::PushUserType(L, &(~UV_(L, 1)), "Vector");
+	PushVector(L, ~UV_(L, 1));
+
+	return 1;
+}
+
+static int UnitTo (lua_State * L)
+{
+	*PV_(L, 1) = ~UV_(L, 2);
+
+	lua_settop(L, 1);
 
 	return 1;
 }
 
 static int UnitF (lua_State * L)
 {
-	Lua::PushUserType(L, &(~Lua::AppTypes::Vector(Lua::F(L, 1), Lua::F(L, 2), Lua::F(L, 3))), "Vector");
+	PushVector(L, ~Lua::AppTypes::Vector(Lua::F(L, 1), Lua::F(L, 2), Lua::F(L, 3)));
 
 	return 1;
 }
 
 static int xz (lua_State * L)
 {
-	Lua::PushUserType(L, &(UV_(L, 1).XZ()), "Vector");
+	PushVector(L, UV_(L, 1).XZ());
 
 	return 1;
 }
 
 static int y (lua_State * L)
 {
-	Lua::PushUserType(L, &(UV_(L, 1).Y()), "Vector");
+	PushVector(L, UV_(L, 1).Y());
 
 	return 1;
 }
@@ -827,36 +1197,67 @@ static const luaL_reg OpsFuncs[] = {
 
 static const luaL_reg TrajectoryFuncs[] = {
 	M_(GetAngles),
+	M_(GetAnglesBatch),
+	M_(GetIntercepts),
 	M_(GetMaxHeight),
+	M_(GetMaxHeightBatch),
 	M_(GetPosition),
+	M_(GetPositionBatch),
 	M_(GetSpeed),
+	M_(GetSpeedBatch),
 	M_(GetTime),
+	M_(GetTimeBatch),
 	M_(GetVelocity),
+	M_(GetVelocityBatch),
 	M_(GetYTimes),
+	M_(GetYTimesBatch),
 	{ 0, 0 }
 };
 
 static const luaL_reg VectorFuncs[] = {
 	M_(Add),
+	M_(AddScaled),
+	M_(AddScaledTo),
+	M_(AddTo),
 	M_(Angle),
 	M_(ClampToMax),
 	M_(Copy),
+	M_(CopyTo),
 	M_(Cross),
+	M_(CrossTo),
 	M_(Div),
+	M_(DivTo),
 	M_(Len),
 	M_(Mul),
+	M_(MulTo),
 	M_(Neg),
+	M_(NegTo),
+	M_(Recycle),
 	M_(ScaleTo),
+	M_(Set),
 	M_(SphereInvert),
 	M_(Sub),
+	M_(SubTo),
 	M_(TLen),
 	M_(Unit),
 	M_(UnitF),
+	M_(UnitTo),
 	M_(xz),
 	M_(y),
 	{ 0, 0 }
 };
 
+static const luaL_reg VectorMethods[] = {
+	{ "__add", Add },
+	{ "__div", Div },
+	{ "__len", Len },
+	{ "__mul", Mul },
+	{ "__pow", Cross },
+	{ "__sub", Sub },
+	{ "__unm", Neg },
+	{ 0, 0 }
+};
+
 #undef M_
 #define RT_(r, n, c, m, t) (r).mName = #n, (r).mUserType = 0, (r).mOffset = offsetof(c, m), (r).mType = t
 #define RU_(r, n, c, m, u) (r).mName = #n, (r).mUserType = u, (r).mOffset = offsetof(c, m), (r).mType = Lua::UserType_Reg::eUserType
@@ -885,15 +1286,28 @@ void luaopen_misc (lua_State * L)
 	RT_(R[0], x, Lua::AppTypes::Vector, m[0], Lua::UserType_Reg::eFloat);
 	RT_(R[1], y, Lua::AppTypes::Vector, m[1], Lua::UserType_Reg::eFloat);
 	RT_(R[2], z, Lua::AppTypes::Vector, m[2], Lua::UserType_Reg::eFloat);
-	Lua::RegisterUserType(L, "Vector", R, 3, sizeof(Lua::AppTypes::Vector), "__add __sub __mul __div __pow __unm __len", Add, Sub, Mul, Div, Cross, Neg, Len);
-
-	// Install tables.
-	luaL_register(L, "Collision", CollisionFuncs);
-	luaL_register(L, "Math", MathFuncs);
-	luaL_register(L, "Misc", MiscFuncs);
-	luaL_register(L, "Ops", OpsFuncs);
-	luaL_register(L, "Trajectory", TrajectoryFuncs);
-	luaL_register(L, "Vec", VectorFuncs);
+	Lua::RegisterUserType(L, "Vector", R, 3, sizeof(Lua::AppTypes::Vector), "");
+
+	// Install the Vector metamethods and tables, with the metatable and vector pool as
+	// upvalues.
+	luaL_getmetatable(L, "Vector");	// mt
+	lua_newtable(L);// mt, pool
+
+	const luaL_reg * funcs[] = { VectorMethods, CollisionFuncs, MathFuncs, MiscFuncs, OpsFuncs, TrajectoryFuncs, VectorFuncs };
+	char const * names[] = { 0, "Collision", "Math", "Misc", "Ops", "Trajectory", "Vec" };
+
+	for (int index = 0; index < int(sizeof(funcs) / sizeof(funcs[0])); ++index)
+	{
+		if (0 == names[index]) lua_pushvalue(L, -2);// mt, pool, mt
+
+		lua_pushvalue(L, names[index] != 0 ? -2 : -3);	// mt, pool[, mt], mt
+		lua_pushvalue(L, names[index] != 0 ? -2 : -3);	// mt, pool[, mt], mt, pool
+
+		luaI_openlib(L, names[index], funcs[index], 2);	// mt, pool, mt or t
+		lua_pop(L, 1);	// mt, pool
+	}
+
+	lua_pop(L, 2);
 }
 
 #undef RT_
@@ -0,0 +1,265 @@
+#include "App.h"
+#include "Steering.h"
+
+///
+/// Type handlers
+///
+static inline Steering::Accumulator * UA (lua_State * L, int index)
+{
+	return *static_cast<Steering::Accumulator**>(Lua::UD(L, index));
+}
+
+static inline Steering::Flock * UF (lua_State * L, int index)
+{
+	return *static_cast<Steering::Flock**>(Lua::UD(L, index));
+}
+
+static inline Steering::Vector * UV (lua_State * L, int index)
+{
+	return static_cast<Steering::Vector*>(Lua::UT(L, index));
+}
+
+///
+/// Accumulator functions
+///
+// scale: Scale applied to the channel's forces
+// Returns the channel index
+static int AccumulatorAddChannel (lua_State * L)
+{
+	lua_pushinteger(L, UA(L, 1)->AddChannel(Lua::F(L, 2)) + 1);
+
+	return 1;
+}
+
+static int AccumulatorClear (lua_State * L)
+{
+	UA(L, 1)->Clear();
+
+	return 0;
+}
+
+static int AccumulatorGetChannelCount (lua_State * L)
+{
+	lua_pushinteger(L, UA(L, 1)->GetChannelCount());
+
+	return 1;
+}
+
+// out: If present, vector that receives the force; otherwise, a new one is made
+// Returns the resolved force
+static int AccumulatorResolve (lua_State * L)
+{
+	static Lua::UserType * spVector;
+
+	Steering::Vector force = UA(L, 1)->Resolve();
+
+	if (lua_isnoneornil(L, 2))
+	{
+		if (0 == spVector) spVector = Lua::GetUserType(L, "Vector");
+
+		Lua::PushUserType(L, &force, spVector);	// A, out, force
+	}
+
+	else
+	{
+		*UV(L, 2) = force;
+
+		lua_settop(L, 2);	// A, out
+	}
+
+	return 1;
+}
+
+// channel: Channel index
+// force: Force to set, before scaling
+static int AccumulatorSet (lua_State * L)
+{
+	Steering::Accumulator * pA = UA(L, 1);
+
+	Lua::Uint channel = Lua::U(L, 2);
+
+	if (channel >= 1 && channel <= pA->GetChannelCount()) pA->Set(channel - 1, *UV(L, 3));
+
+	return 0;
+}
+
+// max: If present, greatest length of the resolved force; otherwise, it is unlimited
+static int AccumulatorSetMax (lua_State * L)
+{
+	UA(L, 1)->SetMax(lua_isnoneornil(L, 2) ? 0.0f : Lua::F(L, 2), !lua_isnoneornil(L, 2));
+
+	return 0;
+}
+
+// order: Array of channel indices, by priority
+static int AccumulatorSetOrder (lua_State * L)
+{
+	Steering::Accumulator * pA = UA(L, 1);
+
+	std::vector<Lua::Uint> order;
+
+	for (int i = 1; i <= int(lua_objlen(L, 2)); ++i)
+	{
+		lua_rawgeti(L, 2, i);	// A, order, channel
+
+		Lua::Uint channel = Lua::Uint(lua_tointeger(L, -1));
+
+		if (channel >= 1 && channel <= pA->GetChannelCount()) order.push_back(channel - 1);
+
+		lua_pop(L, 1);	// A, order
+	}
+
+	pA->SetOrder(order.empty() ? 0 : &order[0], Lua::Uint(order.size()));
+
+	return 0;
+}
+
+// channel: Channel index
+// scale: Scale applied to forces set afterward
+static int AccumulatorSetScale (lua_State * L)
+{
+	Steering::Accumulator * pA = UA(L, 1);
+
+	Lua::Uint channel = Lua::U(L, 2);
+
+	if (channel >= 1 && channel <= pA->GetChannelCount()) pA->SetScale(channel - 1, Lua::F(L, 3));
+
+	return 0;
+}
+
+///
+/// Flock functions
+///
+// position: Agent position
+// heading: Agent heading
+// range: Distance within which other agents are neighbors
+// Returns the agent index
+static int FlockAdd (lua_State * L)
+{
+	Steering::Flock * pF = UF(L, 1);
+
+	pF->Add(*UV(L, 2), *UV(L, 3), Lua::F(L, 4));
+
+	lua_pushinteger(L, pF->GetCount());
+
+	return 1;
+}
+
+static int FlockClear (lua_State * L)
+{
+	UF(L, 1)->Clear();
+
+	return 0;
+}
+
+static int FlockGetCount (lua_State * L)
+{
+	lua_pushinteger(L, UF(L, 1)->GetCount());
+
+	return 1;
+}
+
+// index: Agent index
+// alignment, cohesion, separation: Vectors that receive the agent's group forces
+// Returns the agent's neighbor count
+static int FlockGetForces (lua_State * L)
+{
+	Steering::Flock * pF = UF(L, 1);
+
+	Lua::Uint index = Lua::U(L, 2);
+
+	if (index < 1 || index > pF->GetCount()) return 0;
+
+	// Write the forces into the vectors, so that none are made.
+	for (int c = 0; c < Steering::eChannelCount; ++c) *UV(L, 3 + c) = pF->GetForce(index - 1, Steering::Channel(c));
+
+	lua_pushinteger(L, pF->GetNeighborCount(index - 1));
+
+	return 1;
+}
+
+static int FlockUpdate (lua_State * L)
+{
+	UF(L, 1)->Update();
+
+	return 0;
+}
+
+///
+/// Garbage collectors
+///
+static int Accumulator__gc (lua_State * L)
+{
+	delete UA(L, 1);
+
+	return 0;
+}
+
+static int Flock__gc (lua_State * L)
+{
+	delete UF(L, 1);
+
+	return 0;
+}
+
+///
+/// Function tables
+///
+#define M_(w) { #w, Accumulator##w }
+
+static const luaL_reg AccumulatorFuncs[] = {
+	M_(__gc),
+	M_(AddChannel),
+	M_(Clear),
+	M_(GetChannelCount),
+	M_(Resolve),
+	M_(Set),
+	M_(SetMax),
+	M_(SetOrder),
+	M_(SetScale),
+	{ 0, 0 }
+};
+
+#undef M_
+
+#define M_(w) { #w, Flock##w }
+
+static const luaL_reg FlockFuncs[] = {
+	M_(__gc),
+	M_(Add),
+	M_(Clear),
+	M_(GetCount),
+	M_(GetForces),
+	M_(Update),
+	{ 0, 0 }
+};
+
+#undef M_
+
+///
+/// New functions
+///
+static int AccumulatorNew (lua_State * L)
+{
+	Steering::Accumulator * pA = new Steering::Accumulator;
+
+	memcpy(Lua::UD(L, 1), &pA, sizeof(Steering::Accumulator*));
+
+	return 0;
+}
+
+static int FlockNew (lua_State * L)
+{
+	Steering::Flock * pF = new Steering::Flock;
+
+	memcpy(Lua::UD(L, 1), &pF, sizeof(Steering::Flock*));
+
+	return 0;
+}
+
+/// @brief Binds the steering system to the Lua scripting system
+void luaopen_steering (lua_State * L)
+{
+	Lua::class_Define(L, "SteeringAccumulator", AccumulatorFuncs, AccumulatorNew, 0, sizeof(Steering::Accumulator*));
+	Lua::class_Define(L, "SteeringFlock", FlockFuncs, FlockNew, 0, sizeof(Steering::Flock*));
+}
\ No newline at end of file
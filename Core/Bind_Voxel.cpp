@@ -1,5 +1,9 @@
 #include "App.h"
 #include "../Voxel/Voxel.h"
+#include "../Voxel/AABox.h"
+#include "../Voxel/Capsule.h"
+#include "../Voxel/Grid.h"
+#include "../Voxel/Quad.h"
 #include "../Voxel/Sphere.h"
 
 /// @brief Iterates over a sphere volumetrically
@@ -21,11 +25,11 @@ static void RenderSphereVolume (float center[3], float radius, float dx, float d
 	// Render the sphere.
 	Voxel::Sphere s(center, radius, dx, dy, dz, order);
 
-	for (Voxel::ColumnIterF vci = s.begin(); vci != s.end(); ++vci)
+	for (Voxel::Sphere::ColumnIterF vci = s.begin(); vci != s.end(); ++vci)
 	{
-		for (Voxel::RowIterF vri = vci.begin(); vri != vci.end(); ++vri)
+		for (Voxel::Sphere::RowIterF vri = vci.begin(); vri != vci.end(); ++vri)
 		{
-			for (Voxel::SpanIterF vsi = vri.begin(); vsi != vri.end(); ++vsi)
+			for (Voxel::Sphere::SpanIterF vsi = vri.begin(); vsi != vri.end(); ++vsi)
 			{
 				func(*vci, *vri, vsi.I(), vsi.F(), context);
 			}
@@ -40,26 +44,415 @@ static void Callback (int y, int z, int x1, int x2, void * context)
 {
 	lua_State * L = static_cast<lua_State*>(context);
 
-	lua_getglobal(L, "CFunc");	// CFunc
-	lua_pushinteger(L, y);	// CFunc, z
-	lua_pushinteger(L, z);	// CFunc, z, y
-	lua_pushinteger(L, x1);	// CFunc, z, y, x1
-	lua_pushinteger(L, x2);	// CFunc, z, y, x1, x2
+	lua_pushvalue(L, 6);// func
+	lua_pushinteger(L, y);	// func, y
+	lua_pushinteger(L, z);	// func, y, z
+	lua_pushinteger(L, x1);	// func, y, z, x1
+	lua_pushinteger(L, x2);	// func, y, z, x1, x2
 	lua_call(L, 4, 0);
 }
 
 static int RenderSphereVolume (lua_State * L)
 {
-	lua_pushvalue(L, 6);// ..., func
-	lua_setglobal(L, "CFunc");	// _G.CFunc = func
+	luaL_checktype(L, 6, LUA_TFUNCTION);
 
 	RenderSphereVolume(static_cast<Lua::AppTypes::Vector*>(Lua::UD(L, 1))->m, Lua::F(L, 2), Lua::F(L, 3), Lua::F(L, 4), Lua::F(L, 5), Callback, Voxel::eYZX, L);
 
 	return 0;
 }
 
+///
+/// Helpers
+///
+// Builds a sphere from the center and radius at index and index + 1, raising any error
+static Voxel::Sphere * NewSphere (lua_State * L, int index, float dx, float dy, float dz)
+{
+	float center[3];
+
+	memcpy(center, static_cast<Lua::AppTypes::Vector*>(Lua::UD(L, index))->m, sizeof(center));
+
+	Voxel::Sphere * pS = 0;
+	char const * error = 0;
+
+	try {
+		pS = new Voxel::Sphere(center, Lua::F(L, index + 1), dx, dy, dz, Voxel::eYZX);
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelSphere: %s", error);
+
+	return pS;
+}
+
+// Copies count spans from a shape, starting at first, into the array at index 2
+template<typename S> static int PushSpans (lua_State * L, S & shape, std::size_t first, std::size_t count)
+{
+	// Copy the spans into a buffer in chunks, then move each chunk into the array.
+	int spans[4 * 256], index = 1;
+
+	for (std::size_t got; count > 0; first += got, count -= got)
+	{
+		got = shape.GetSpans(spans, first, count < 256 ? count : 256);
+
+		for (std::size_t i = 0; i < 4 * got; ++i)
+		{
+			lua_pushinteger(L, spans[i]);	// S, out, ..., cell
+			lua_rawseti(L, 2, index++);	// S, out, ...
+		}
+	}
+
+	return (index - 1) / 4;
+}
+
+///
+/// Type handlers
+///
+static inline float * UV (lua_State * L, int index)
+{
+	return static_cast<Lua::AppTypes::Vector*>(Lua::UD(L, index))->m;
+}
+
+static inline Voxel::Grid * UG (lua_State * L, int index)
+{
+	return *static_cast<Voxel::Grid**>(Lua::UD(L, index));
+}
+
+static inline Voxel::Sphere * US (lua_State * L, int index)
+{
+	return *static_cast<Voxel::Sphere**>(Lua::UD(L, index));
+}
+
+///
+/// Grid functions
+///
+// Empties the grid
+static int GridClear (lua_State * L)
+{
+	UG(L, 1)->Clear();
+
+	return 0;
+}
+
+// center: Sphere center, relative to space origin
+// radius: Sphere radius
+static int GridEraseSphere (lua_State * L)
+{
+	Voxel::Grid * pG = UG(L, 1);
+	Voxel::Sphere * pS = NewSphere(L, 2, pG->GetD(0), pG->GetD(1), pG->GetD(2));
+
+	pG->Erase(*pS, Voxel::eYZX);
+
+	delete pS;
+
+	return 0;
+}
+
+// center: Sphere center, relative to space origin
+// radius: Sphere radius
+static int GridFillSphere (lua_State * L)
+{
+	Voxel::Grid * pG = UG(L, 1);
+	Voxel::Sphere * pS = NewSphere(L, 2, pG->GetD(0), pG->GetD(1), pG->GetD(2));
+
+	pG->Fill(*pS, Voxel::eYZX);
+
+	delete pS;
+
+	return 0;
+}
+
+// lo: Lesser box corner, relative to space origin
+// hi: Greater box corner, relative to space origin
+static int GridFillBox (lua_State * L)
+{
+	Voxel::Grid * pG = UG(L, 1);
+	char const * error = 0;
+
+	try {
+		Voxel::AABox box(UV(L, 2), UV(L, 3), pG->GetD(0), pG->GetD(1), pG->GetD(2), Voxel::eYZX);
+
+		pG->Fill(box, Voxel::eYZX);
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelGrid: %s", error);
+
+	return 0;
+}
+
+// corner: Quad corner, relative to space origin
+// u, v: Edges from the corner to its neighbors
+// thickness: Slab thickness
+static int GridFillQuad (lua_State * L)
+{
+	Voxel::Grid * pG = UG(L, 1);
+	char const * error = 0;
+
+	try {
+		Voxel::Quad quad(UV(L, 2), UV(L, 3), UV(L, 4), Lua::F(L, 5), pG->GetD(0), pG->GetD(1), pG->GetD(2), Voxel::eYZX);
+
+		pG->Fill(quad, Voxel::eYZX);
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelGrid: %s", error);
+
+	return 0;
+}
+
+// x, y, z: Cell to test
+// Returns: If true, the cell is set
+static int GridGet (lua_State * L)
+{
+	lua_pushboolean(L, UG(L, 1)->Get(Lua::I(L, 2), Lua::I(L, 3), Lua::I(L, 4)));
+
+	return 1;
+}
+
+// Returns the count of allocated bricks
+static int GridGetBrickCount (lua_State * L)
+{
+	lua_pushinteger(L, UG(L, 1)->GetBrickCount());
+
+	return 1;
+}
+
+// Returns the count of set cells
+static int GridGetCount (lua_State * L)
+{
+	lua_pushinteger(L, UG(L, 1)->GetCount());
+
+	return 1;
+}
+
+// out: Array that receives the spans, as column, row, initial, final quads from out[1] on
+// order: If present, ordering of the spans, as "xyz", "xzy", "yxz", "yzx", "zxy", or "zyx"; otherwise, "yzx"
+// Returns the count of spans written; entries past these are left alone
+static int GridGetSpans (lua_State * L)
+{
+	static char const * const orders[] = { "xyz", "xzy", "yxz", "yzx", "zxy", "zyx", 0 };
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	Voxel::GridSpans spans(*UG(L, 1), Voxel::Order(luaL_checkoption(L, 3, "yzx", orders)));
+
+	lua_pushinteger(L, PushSpans(L, spans, 0, spans.GetSpanCount()));
+
+	return 1;
+}
+
+// grid: Grid whose cells are kept where set; its cells must have the same dimensions
+static int GridIntersect (lua_State * L)
+{
+	char const * error = 0;
+
+	try {
+		UG(L, 1)->Intersect(*UG(L, 2));
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelGrid: %s", error);
+
+	return 0;
+}
+
+// grid: Grid whose set cells are cleared; its cells must have the same dimensions
+static int GridSubtract (lua_State * L)
+{
+	char const * error = 0;
+
+	try {
+		UG(L, 1)->Subtract(*UG(L, 2));
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelGrid: %s", error);
+
+	return 0;
+}
+
+// p1: Segment start, e.g. a ball's position before a step
+// p2: Segment end, e.g. its position after
+// radius: Capsule radius
+// Returns: If true, some cell in the capsule is set
+static int GridTestCapsule (lua_State * L)
+{
+	Voxel::Grid * pG = UG(L, 1);
+	char const * error = 0;
+	bool bHit = false;
+
+	try {
+		Voxel::Capsule capsule(UV(L, 2), UV(L, 3), Lua::F(L, 4), pG->GetD(0), pG->GetD(1), pG->GetD(2), Voxel::eYZX);
+
+		bHit = pG->Test(capsule, Voxel::eYZX);
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelGrid: %s", error);
+
+	lua_pushboolean(L, bHit);
+
+	return 1;
+}
+
+// center: Sphere center, relative to space origin
+// radius: Sphere radius
+// Returns: If true, some cell in the sphere is set
+static int GridTestSphere (lua_State * L)
+{
+	Voxel::Grid * pG = UG(L, 1);
+	Voxel::Sphere * pS = NewSphere(L, 2, pG->GetD(0), pG->GetD(1), pG->GetD(2));
+
+	bool bHit = pG->Test(*pS, Voxel::eYZX);
+
+	delete pS;
+
+	lua_pushboolean(L, bHit);
+
+	return 1;
+}
+
+// grid: Grid whose set cells are added; its cells must have the same dimensions
+static int GridUnion (lua_State * L)
+{
+	char const * error = 0;
+
+	try {
+		UG(L, 1)->Union(*UG(L, 2));
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelGrid: %s", error);
+
+	return 0;
+}
+
+///
+/// Sphere functions
+///
+// Returns the count of spans in the sphere
+static int SphereGetSpanCount (lua_State * L)
+{
+	lua_pushinteger(L, US(L, 1)->GetSpanCount());
+
+	return 1;
+}
+
+// out: Array that receives the spans, as y, z, x1, x2 quads from out[1] on
+// first: If present, index of first span to get, for streaming in chunks; otherwise, 1
+// count: If present, greatest count of spans to get; otherwise, all that remain
+// Returns the count of spans written; entries past these are left alone
+static int SphereGetSpans (lua_State * L)
+{
+	Voxel::Sphere * pS = US(L, 1);
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	std::size_t first = luaL_optint(L, 3, 1) - 1, total = pS->GetSpanCount();
+	std::size_t count = lua_isnoneornil(L, 4) ? total : std::size_t(Lua::U(L, 4));
+
+	if (first >= total) count = 0;
+
+	else if (count > total - first) count = total - first;
+
+	lua_pushinteger(L, PushSpans(L, *pS, first, count));
+
+	return 1;
+}
+
+///
+/// Garbage collectors
+///
+static int Grid__gc (lua_State * L)
+{
+	delete UG(L, 1);
+
+	return 0;
+}
+
+static int Sphere__gc (lua_State * L)
+{
+	delete US(L, 1);
+
+	return 0;
+}
+
+///
+/// Function tables
+///
+#define M_(w) { #w, Grid##w }
+
+static const luaL_reg GridFuncs[] = {
+	M_(__gc),
+	M_(Clear),
+	M_(EraseSphere),
+	M_(FillBox),
+	M_(FillQuad),
+	M_(FillSphere),
+	M_(Get),
+	M_(GetBrickCount),
+	M_(GetCount),
+	M_(GetSpans),
+	M_(Intersect),
+	M_(Subtract),
+	M_(TestCapsule),
+	M_(TestSphere),
+	M_(Union),
+	{ 0, 0 }
+};
+
+#undef M_
+
+#define M_(w) { #w, Sphere##w }
+
+static const luaL_reg SphereFuncs[] = {
+	M_(__gc),
+	M_(GetSpanCount),
+	M_(GetSpans),
+	{ 0, 0 }
+};
+
+#undef M_
+
+///
+/// New functions
+///
+// dx, dy, dz: Extents of space cell
+static int GridNew (lua_State * L)
+{
+	// Clear the handle first, in case construction fails and the object is collected.
+	Voxel::Grid * pG = 0;
+
+	memcpy(Lua::UD(L, 1), &pG, sizeof(Voxel::Grid*));
+
+	char const * error = 0;
+
+	try {
+		pG = new Voxel::Grid(Lua::F(L, 2), Lua::F(L, 3), Lua::F(L, 4));
+	} catch (char const * what) { error = what; }
+
+	if (error) luaL_error(L, "VoxelGrid: %s", error);
+
+	memcpy(Lua::UD(L, 1), &pG, sizeof(Voxel::Grid*));
+
+	return 0;
+}
+
+// center: Sphere center, relative to space origin
+// radius: Sphere radius
+// dx, dy, dz: Extents of space cell
+static int SphereNew (lua_State * L)
+{
+	// Clear the handle first, in case construction fails and the object is collected.
+	Voxel::Sphere * pS = 0;
+
+	memcpy(Lua::UD(L, 1), &pS, sizeof(Voxel::Sphere*));
+
+	pS = NewSphere(L, 2, Lua::F(L, 4), Lua::F(L, 5), Lua::F(L, 6));
+
+	memcpy(Lua::UD(L, 1), &pS, sizeof(Voxel::Sphere*));
+
+	return 0;
+}
+
 void luaopen_voxel (lua_State * L)
 {
 	lua_pushcfunction(L, RenderSphereVolume);
 	lua_setglobal(L, "RenderSphereVolume");
+
+	Lua::class_Define(L, "VoxelGrid", GridFuncs, GridNew, 0, sizeof(Voxel::Grid*));
+	Lua::class_Define(L, "VoxelSphere", SphereFuncs, SphereNew, 0, sizeof(Voxel::Sphere*));
 }
\ No newline at end of file
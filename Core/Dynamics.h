@@ -0,0 +1,382 @@
+#ifndef DYNAMICS_H
+#define DYNAMICS_H
+
+#include "App.h"
+#include <cstdio>
+#include <vector>
+
+struct SDL_semaphore;
+struct SDL_Thread;
+
+namespace Dynamics
+{
+	typedef Lua::Uint Uint;
+	typedef Lua::AppTypes::Quad Quad;
+	typedef Lua::AppTypes::Sphere Sphere;
+	typedef Lua::AppTypes::Vector Vector;
+
+	/// @brief Window within which hits are considered simultaneous
+	const float fSimultaneity = 0.001f;
+
+	/// @brief Count of consecutive steps without progress after which objects are stuck
+	const Uint StuckSteps = 8;
+
+	/// @brief Fewest objects per lane for which events are loaded in parallel
+	const Uint LaneSize = 32;
+
+	/// @brief Hit storage
+	struct Hit {
+		Vector mContact;///< Point of collision contact
+		Vector mNormal;	///< Normal at collision point
+		float mT;	///< Time of hit
+		bool mInit;	///< Initialization flag
+
+		// Methods
+		Hit (float fLimit) : mT(fLimit), mInit(false) {};
+
+		void AddHit (Vector const & contact, Vector const & normal, float fT);
+	};
+
+	/// @brief Object entry
+	struct Object {
+		Sphere mSphere;	///< Bounding sphere
+		Vector mMotion;	///< Motion over unit time
+		Uint mType;	///< Material type
+		Uint mRevision;	///< Course revision, or 0 if unknown
+	};
+
+	/// @brief Wall entry
+	struct Wall {
+		Quad mQuad;	///< Wall geometry
+		Uint mType;	///< Material type
+
+		Wall (Quad const & quad, Uint type) : mQuad(quad), mType(type) {}
+	};
+
+	/// @brief Axis-aligned bounding box
+	struct Box {
+		Vector mMin;///< Minimum corner
+		Vector mMax;///< Maximum corner
+
+		Box (void) {}
+		Box (Quad const & quad);
+		Box (Sphere const & sphere, Vector const & motion, float fLimit);
+
+		bool Overlaps (Box const & box) const;
+	};
+
+	/// @brief Static bounding volume hierarchy over boxes
+	class Tree {
+	private:
+		/// @brief Tree node
+		struct Node {
+			Box mBox;	///< Bounds of node contents
+			Uint mFirst;///< Leaf: first entry in index list; branch: index of right child
+			Uint mCount;///< Leaf: count of entries; branch: 0
+		};
+	// Members
+		std::vector<Node> mNodes;	///< Nodes, with each left child following its parent
+		std::vector<Uint> mIndices;	///< Box indices, grouped by leaf
+		std::vector<Box> mBoxes;	///< Boxes in the tree
+	// Methods
+		void Split (Uint first, Uint count);
+	public:
+	// Interface
+		void Add (Box const & box);
+		void Build (void);
+		void Clear (void);
+		void Query (Box const & box, std::vector<Uint> & indices) const;
+
+		Uint GetCount (void) const;
+	};
+
+	/// @brief Spheres and motions laid out as arrays, for batched tests
+	struct SphereBatch {
+		std::vector<float> mCX, mCY, mCZ;	///< Sphere centers
+		std::vector<float> mVX, mVY, mVZ;	///< Sphere motions
+		std::vector<float> mR;	///< Sphere radii
+
+		void Add (Sphere const & sphere, Vector const & motion);
+		void Clear (void);
+
+		Uint GetCount (void) const;
+	};
+
+	/// @brief Walls laid out as arrays, with edge data computed up front, for batched tests
+	struct WallTable {
+		std::vector<float> mPX[4], mPY[4], mPZ[4];	///< Corners
+		std::vector<float> mEX[4], mEY[4], mEZ[4];	///< Edges, from each corner to the next
+		std::vector<float> mUX[4], mUY[4], mUZ[4];	///< Edge unit vectors
+		std::vector<float> mLength[4];	///< Edge lengths
+		std::vector<float> mNX, mNY, mNZ;	///< Plane normals
+		std::vector<Uint8> mETest;	///< Edges to test, one bit per corner
+		std::vector<Uint8> mVTest;	///< Vertices to test, one bit per corner
+		std::vector<Uint8> mPlaneOnly;	///< If nonzero, only the plane is tested
+
+		void Add (Quad const & quad);
+		void Clear (void);
+
+		Uint GetCount (void) const;
+	};
+
+	/// @brief Swept extent of an object along the sort axis
+	struct Extent {
+		float mMin;	///< Lower bound
+		float mMax;	///< Upper bound
+	};
+
+	/// @brief Contact between an object and another object or a wall
+	struct Contact {
+		Uint mObject;	///< Index of object
+		Uint mOther;///< Index of other object or wall
+		bool mWall;	///< If true, the other index refers to a wall
+		Vector mPoint;	///< Point of contact
+		Vector mNormal;	///< Normal at contact
+	};
+
+	/// @brief State of an object along a predicted path
+	struct PathState {
+		Vector mPosition;	///< Object position
+		Vector mMotion;	///< Object motion
+		float mTime;///< Time since the start of the path
+	};
+
+	class World;
+
+	/// @brief Path predicted for an object, kept between predictions so that what remains
+	///        valid of it may be reused
+	struct Path {
+		std::vector<PathState> mStates;	///< Start state; states after each bounce, and where the path was resumed; end state
+		Vector mForce;	///< Force applied to the object over unit time
+		World const * mWorld;	///< World the path was predicted in
+		float mRadius;	///< Object radius
+		Uint mType;	///< Object material type
+		Uint mWallRevision;	///< Revision of the walls the path was predicted against
+		Uint mMaterialRevision;	///< Revision of the materials the path was predicted with
+
+		Path (void) : mWorld(0), mRadius(0.0f), mType(0), mWallRevision(0), mMaterialRevision(0) {}
+
+		PathState GetState (float fTime) const;
+
+		bool Locate (Vector const & position, Vector const & motion, float fTolerance, Uint & index, float & fT) const;
+
+		void Truncate (float fTime);
+	};
+
+	/// @brief Launch to search for a shot from, with how its candidates are predicted
+	struct ShotQuery {
+		Sphere mSphere;	///< Bounding sphere of object at launch
+		Vector mTarget;	///< Point the shot should reach
+		Vector mForce;	///< Force applied to the object over unit time
+		Uint mType;	///< Object material type
+		Uint mLimit;///< Count of bounces after which the rest of a step is dropped
+		float mTime;///< Time to predict ahead
+		float mStep;///< Time step of prediction
+		float mRestitution;	///< Restitution factor of a bounce
+		float mEpsilon;	///< Displacement away from a wall after bouncing off it
+		float mCeiling;	///< Greatest height a shot may reach
+	};
+
+	/// @brief Shot candidate, with what its predicted path shows
+	struct Shot {
+		float mSpeed;	///< Launch speed
+		float mAngle;	///< Launch angle
+		float mCost;///< Cost of shot; lower is better
+		float mDistance;///< Closest approach of the object to the target
+		float mTime;///< Time of closest approach
+		float mPeak;///< Greatest height along the path
+		Uint mBounces;	///< Count of bounces along the path
+
+		bool operator < (Shot const & shot) const { return mCost < shot.mCost; }
+	};
+
+	/// @brief Predicted contact between an object and another object or a wall
+	struct Event {
+		Uint mObject;	///< Index of object
+		Uint mOther;///< Index of other object or wall
+		float mT;	///< Time of contact, or -1 if there is none
+		bool mWall;	///< If true, the other index refers to a wall
+		bool mExact;///< If true, the time was computed this step; otherwise, it is carried over
+
+		Event (Uint object, Uint other, bool bWall) : mObject(object), mOther(other), mT(-1.0f), mWall(bWall), mExact(true) {}
+	};
+
+	/// @brief Scope over which floating-point behavior is pinned, for repeatable results
+	class FPState {
+	private:
+	// Members
+		unsigned int mControl;	///< Saved x87 control word
+		unsigned int mCSR;	///< Saved SSE control and status register
+		bool mPinned;	///< If true, the state was pinned and must be restored
+	public:
+	// Lifetime
+		FPState (bool bPin);
+		~FPState (void);
+	};
+
+	/// @brief Pool of threads that run a job in lanes, alongside the calling thread
+	/// @note One pool is shared by all worlds, which acquire and release it
+	class Workers {
+	private:
+		/// @brief Worker thread state
+		struct Thread {
+			Workers * mOwner;	///< Pool to which the thread belongs
+			SDL_Thread * mThread;	///< Thread handle
+			SDL_semaphore * mStart;	///< Signaled when the thread has a lane to run
+			Uint mLane;	///< Lane run by the thread
+		};
+	// Members
+		std::vector<Thread *> mThreads;	///< Worker threads
+		SDL_semaphore * mDone;	///< Signaled as each worker finishes its lane
+		void (*mJob)(void *, Uint);	///< Job being run
+		void * mData;	///< Job data
+		Uint mUsers;///< Count of worlds using the pool
+		bool mQuit;	///< If true, the workers are shutting down
+	// Methods
+		static int Main (void * pThread);
+
+		void SetCount (Uint count);
+	// Lifetime
+		Workers (void);
+		~Workers (void);
+
+		Workers (Workers const &);
+		Workers & operator = (Workers const &);
+	public:
+	// Lifetime
+		static Workers & Acquire (void);
+		static void Release (void);
+	// Interface
+		void Reserve (Uint count);
+		void Run (void (*job)(void *, Uint), void * pData, Uint count);
+
+		Uint GetCount (void) const;
+	};
+
+	/// @brief Range of objects whose events are loaded together, with its working state
+	struct Lane {
+		Uint mFirst;///< Index of first object
+		Uint mEnd;	///< Index past last object
+		std::vector<Event> mEvents;	///< Events found, in test order
+		std::vector<Uint> mCandidates;	///< Walls found by a tree query
+		std::vector<Uint> mBatched;	///< Events loaded into the current batch
+		std::vector<Uint> mQuads;	///< Walls loaded into the current batch
+		std::vector<float> mTimes;	///< Times found by the current batch
+		SphereBatch mBatch;	///< Candidate objects for batched tests
+	};
+
+	/// @brief Shot candidates planned together, with their working state
+	struct ShotLane {
+		Path mPath;	///< Path of the candidate being planned
+		std::vector<Uint> mCandidates;	///< Walls near the arc being predicted
+		std::vector<Contact> mHits;	///< Earliest simultaneous hits along the arc being predicted
+	};
+
+	/// @brief Collision world over packed objects and walls
+	class World {
+	private:
+	// Members
+		std::vector<Object> mObjects;	///< Objects in motion
+		std::vector<Wall> mWalls;	///< Static walls
+		std::vector<Contact> mContacts;	///< Earliest simultaneous contacts
+		std::vector<Contact> mPrevContacts;	///< Contacts from the previous step
+		std::vector<Event> mEvents;	///< Predicted contacts, in test order
+		std::vector<Event> mPrevEvents;	///< Predicted contacts from the previous step
+		std::vector<Object> mPrevObjects;	///< Objects as of the previous step
+		std::vector<Uint8> mTouched;	///< Per object, if nonzero, it departed from its prediction
+		std::vector<Uint> mQueue;	///< Heap of events, by time
+		std::vector<Extent> mExtents;	///< Swept object extents
+		std::vector<std::pair<Uint, Uint> > mPairs;	///< Candidate object-object pairs
+		std::vector<Uint> mOrder;	///< Objects sorted by extent lower bound
+		std::vector<Lane> mLanes;	///< Object ranges whose events are loaded in parallel
+		std::vector<ShotLane> mShotLanes;	///< Shot candidates planned in parallel
+		std::vector<Wall> mBuiltWalls;	///< Walls as of the last rebuild
+		std::vector<Box> mChangedBoxes;	///< Bounds of walls changed by the last rebuild, before and after
+		std::vector<Uint> mPathCandidates;	///< Walls near the arc being predicted
+		std::vector<Contact> mPathHits;	///< Earliest simultaneous hits along the arc being predicted
+		Workers & mWorkers;	///< Shared threads used to load events and plan shots
+		WallTable mWallTable;	///< Wall edge data for batched tests
+		Tree mTree;	///< Hierarchy over wall bounds
+		std::vector<Uint8> mMaterials;	///< Object-object pairs to test, by type
+		std::vector<Uint8> mWallMaterials;	///< Object-wall pairs to test, by type
+		std::vector<Uint8> mLoggedMaterials;	///< Material tables as last logged
+		FILE * mLog;///< Step log, if logging
+		Uint mAxis;	///< Sort axis
+		Uint mTypeCount;///< Count of types covered by the material tables
+		Uint mStuckCount;	///< Count of consecutive steps making no progress
+		Uint mWallRevision;	///< Revision number, changed whenever the walls are rebuilt
+		Uint mMaterialRevision;	///< Revision number, changed whenever the materials change
+		Uint mWorkerCount;	///< Count of shared threads used, besides the calling thread
+		float mLimit;	///< Time limit of the events being loaded
+		float mTime;///< Time of the earliest contacts
+		float mPrevTime;///< Time of the previous step
+		bool mDeterministic;///< If true, floating-point behavior is pinned while finding hits
+		bool mLogWalls;	///< If true, the walls are to be logged with the next step
+		bool mTreeDirty;///< If true, the walls have changed since the tree was built
+		bool mWallsChanged;	///< If true, the walls have changed since the previous step
+	// Methods
+		static void LoadJob (void * pWorld, Uint lane);
+		static void ShotJob (void * pPlan, Uint lane);
+
+		bool Tests (std::vector<Uint8> const & materials, Uint type1, Uint type2);
+
+		bool FindPrevious (Event & event, Uint & prev);
+
+		bool ReplayStep (FILE * fp);
+
+		void AddContact (Uint object, Uint other, bool bWall, Hit const & hit);
+		void ExtendPath (Path & path, float fTime, float step, Uint limit, float fRestitution, float fEpsilon, std::vector<Uint> & candidates, std::vector<Contact> & hits);
+		void FindPairs (float fLimit);
+		void LoadEvents (void);
+		void LoadLane (Lane & lane);
+		void LogStep (float step);
+		void MarkTouched (void);
+		void PlanShot (ShotLane & lane, ShotQuery const & query, Shot & shot);
+		void Reserve (Uint type);
+		void ResetPrediction (void);
+		void ResolveEvents (float fLimit);
+		void UpdateStuck (void);
+		void UpdateWalls (void);
+	public:
+	// Lifetime
+		World (void);
+		~World (void);
+	// Interface
+		void AddObject (Sphere const & sphere, Vector const & motion, Uint type, Uint revision = 0);
+		void AddWall (Quad const & quad, Uint type);
+		void ClearMaterials (void);
+		void ClearObjects (void);
+		void ClearWalls (void);
+		void PlanShots (ShotQuery const & query, float const * speeds, Uint nspeeds, float const * angles, Uint nangles, std::vector<Shot> & shots);
+		void SetDeterministic (bool bDeterministic);
+		void SetMaterial (Uint type1, Uint type2, bool bWall);
+		void SetWorkerCount (Uint count);
+		void StopLog (void);
+
+		Contact const & GetContact (Uint index);
+
+		float FindHits (float step);
+
+		bool IsDeterministic (void);
+		bool IsStuck (void);
+		bool Replay (char const * name, Uint & steps, Uint & mismatch);
+		bool StartLog (char const * name);
+
+		Uint GetContactCount (void);
+		Uint GetObjectCount (void);
+		Uint GetWallCount (void);
+		Uint GetWorkerCount (void);
+		Uint PredictPath (Path & path, Sphere const & sphere, Vector const & motion, Vector const & force, Uint type, float fTime, float step, Uint limit, float fRestitution, float fEpsilon, float fTolerance);
+	};
+
+	Uint GetProcessorCount (void);
+
+	bool BQF (float a, float b, float c, float & t);
+	bool SphereQuad (Sphere const & sphere, Quad const & quad, Vector const & motion, Hit & hit);
+	bool Spheres (Sphere const & s1, Sphere const & s2, Vector const & v1, Vector const & v2, Hit & hit);
+
+	void SphereQuadsBatch (Sphere const & sphere, Vector const & motion, WallTable const & table, Uint const * indices, Uint count, float * times);
+	void SpheresBatch (Sphere const & sphere, Vector const & motion, SphereBatch const & batch, float * times);
+}
+
+#endif // DYNAMICS_H
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "Dynamics.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define DYNAMICS_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace Dynamics
+{
+	/// @brief Adds a sphere to the batch
+	/// @param sphere Sphere to add
+	/// @param motion Sphere motion
+	void SphereBatch::Add (Sphere const & sphere, Vector const & motion)
+	{
+		mCX.push_back(sphere.mCenter.m[0]);
+		mCY.push_back(sphere.mCenter.m[1]);
+		mCZ.push_back(sphere.mCenter.m[2]);
+		mVX.push_back(motion.m[0]);
+		mVY.push_back(motion.m[1]);
+		mVZ.push_back(motion.m[2]);
+		mR.push_back(sphere.mRadius);
+	}
+
+	/// @brief Clears the batch
+	void SphereBatch::Clear (void)
+	{
+		mCX.clear();
+		mCY.clear();
+		mCZ.clear();
+		mVX.clear();
+		mVY.clear();
+		mVZ.clear();
+		mR.clear();
+	}
+
+	/// @brief Gets the count of spheres in the batch
+	/// @return Sphere count
+	Uint SphereBatch::GetCount (void) const
+	{
+		return Uint(mR.size());
+	}
+
+	/// @brief Adds a quad to the table
+	/// @param quad Quad to add
+	void WallTable::Add (Quad const & quad)
+	{
+		for (Uint index = 0; index < 4; ++index)
+		{
+			Vector P = quad.mCorners[index], edge = quad.mCorners[(index + 1) % 4] - P, EU = ~edge;
+
+			mPX[index].push_back(P.m[0]);
+			mPY[index].push_back(P.m[1]);
+			mPZ[index].push_back(P.m[2]);
+			mEX[index].push_back(edge.m[0]);
+			mEY[index].push_back(edge.m[1]);
+			mEZ[index].push_back(edge.m[2]);
+			mUX[index].push_back(EU.m[0]);
+			mUY[index].push_back(EU.m[1]);
+			mUZ[index].push_back(EU.m[2]);
+			mLength[index].push_back(edge.length());
+		}
+
+		mNX.push_back(quad.mNormal.m[0]);
+		mNY.push_back(quad.mNormal.m[1]);
+		mNZ.push_back(quad.mNormal.m[2]);
+
+		Uint8 eTest = 0, vTest = 0;
+
+		for (Uint index = 0; index < 4; ++index)
+		{
+			if (quad.mETest[index]) eTest |= 1 << index;
+			if (quad.mVTest[index]) vTest |= 1 << index;
+		}
+
+		mETest.push_back(eTest);
+		mVTest.push_back(vTest);
+		mPlaneOnly.push_back(quad.mETest.none() && quad.mVTest.none());
+	}
+
+	/// @brief Clears the table
+	void WallTable::Clear (void)
+	{
+		for (Uint index = 0; index < 4; ++index)
+		{
+			mPX[index].clear();
+			mPY[index].clear();
+			mPZ[index].clear();
+			mEX[index].clear();
+			mEY[index].clear();
+			mEZ[index].clear();
+			mUX[index].clear();
+			mUY[index].clear();
+			mUZ[index].clear();
+			mLength[index].clear();
+		}
+
+		mNX.clear();
+		mNY.clear();
+		mNZ.clear();
+		mETest.clear();
+		mVTest.clear();
+		mPlaneOnly.clear();
+	}
+
+	/// @brief Gets the count of quads in the table
+	/// @return Quad count
+	Uint WallTable::GetCount (void) const
+	{
+		return Uint(mNX.size());
+	}
+
+	/// @brief Finds when a moving sphere first touches one quad in a table
+	/// @param sphere Sphere to test
+	/// @param motion Sphere motion
+	/// @param table Table of quads
+	/// @param quad Index of quad
+	/// @return Time of contact, or -1 if there is none
+	/// @note This follows SphereQuad, without the early out that depends on the limit
+	static float SphereQuadOne (Sphere const & sphere, Vector const & motion, WallTable const & table, Uint quad)
+	{
+		float fBest = -1.0f;
+
+		Vector V = motion, N(table.mNX[quad], table.mNY[quad], table.mNZ[quad]), P(table.mPX[0][quad], table.mPY[0][quad], table.mPZ[0][quad]);
+
+		// Switch the normal's sense if the sphere is on the opposite side of the quad.
+		Vector D = sphere.mCenter - P;
+
+		if (D * N < 0.0f) N = -N;
+
+		// Trivially reject parallel / receding spheres not near the plane.
+		float fDN = D * N, fVN = V * N;
+
+		bool bPlaneHit = fVN < -1e-6f;
+
+		if (!bPlaneHit && fDN > sphere.mRadius + 1e-3f) return -1.0f;
+
+		// Find the plane time, quitting if there is nothing to test.
+		float fT = bPlaneHit && sphere.mRadius < fDN ? (sphere.mRadius - fDN) / fVN : 0.0f;
+
+		bPlaneHit &= fT >= 0.0f;
+
+		if (!bPlaneHit && table.mPlaneOnly[quad]) return -1.0f;
+
+		float fV2 = V * V, fR2 = sphere.mRadius * sphere.mRadius;
+
+		// Test the point on the plane against each edge, and the sphere against the edges and
+		// corners flagged for testing.
+		Vector C = sphere.mCenter + fT * V - sphere.mRadius * N;
+
+		for (Uint index = 0; index < 4; ++index)
+		{
+			Uint next = (index + 1) % 4;
+
+			Vector Q(table.mPX[next][quad], table.mPY[next][quad], table.mPZ[next][quad]);
+			Vector edge(table.mEX[index][quad], table.mEY[index][quad], table.mEZ[index][quad]);
+
+			bPlaneHit &= ((Q - C) ^ edge) * N > 0.0f;
+
+			float fDV = D * V, fD2 = D * D, fEdgeT;
+
+			if (table.mETest[quad] & (1 << index))
+			{
+				Vector EU(table.mUX[index][quad], table.mUY[index][quad], table.mUZ[index][quad]);
+
+				float fEV = EU * V, fED = EU * D;
+
+				if (BQF(fV2 - fEV * fEV, V * D - fED * fEV, fD2 - fED * fED - fR2, fEdgeT))
+				{
+					float fOffset = (sphere.mCenter + fEdgeT * V - P) * EU;
+
+					if (fOffset > 0.0f && fOffset < table.mLength[index][quad] && (fBest < 0.0f || fEdgeT < fBest)) fBest = fEdgeT;
+				}
+			}
+
+			if ((table.mVTest[quad] & (1 << index)) && BQF(fV2, fDV, fD2 - fR2, fEdgeT) && (fBest < 0.0f || fEdgeT < fBest)) fBest = fEdgeT;
+
+			P = Q;
+			D = sphere.mCenter - P;
+		}
+
+		if (bPlaneHit && (fBest < 0.0f || fT < fBest)) fBest = fT;
+
+		return fBest;
+	}
+
+#ifdef DYNAMICS_SSE2
+	/// @brief Loads four table entries into a register
+	/// @param data Table column
+	/// @param indices Indices of entries
+	/// @return Register with entries
+	static __m128 Gather (std::vector<float> const & data, Uint const * indices)
+	{
+		return _mm_setr_ps(data[indices[0]], data[indices[1]], data[indices[2]], data[indices[3]]);
+	}
+#endif
+
+	/// @brief Finds when a moving sphere first touches each of several quads in a table
+	/// @param sphere Sphere to test
+	/// @param motion Sphere motion
+	/// @param table Table of quads
+	/// @param indices Indices of quads to test
+	/// @param count Count of quads to test
+	/// @param times [out] Per quad, time of contact, or -1 if there is none
+	/// @note The times follow the same arithmetic as SphereQuad, but ignore the limit, so hits
+	///       must still be checked with it; quads with only a plane test are done four at a
+	///       time when SSE2 is available
+	void SphereQuadsBatch (Sphere const & sphere, Vector const & motion, WallTable const & table, Uint const * indices, Uint count, float * times)
+	{
+		Uint index = 0;
+
+#ifdef DYNAMICS_SSE2
+		__m128 cx = _mm_set1_ps(sphere.mCenter.m[0]), cy = _mm_set1_ps(sphere.mCenter.m[1]), cz = _mm_set1_ps(sphere.mCenter.m[2]);
+		__m128 vx = _mm_set1_ps(motion.m[0]), vy = _mm_set1_ps(motion.m[1]), vz = _mm_set1_ps(motion.m[2]);
+		__m128 r = _mm_set1_ps(sphere.mRadius);
+		__m128 sign = _mm_set1_ps(-0.0f), epsilon = _mm_set1_ps(-1e-6f), zero = _mm_setzero_ps(), none = _mm_set1_ps(-1.0f);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			Uint const * quads = indices + index;
+
+			// Switch the normal's sense where the sphere is on the opposite side of the quad.
+			__m128 dX = _mm_sub_ps(cx, Gather(table.mPX[0], quads));
+			__m128 dY = _mm_sub_ps(cy, Gather(table.mPY[0], quads));
+			__m128 dZ = _mm_sub_ps(cz, Gather(table.mPZ[0], quads));
+			__m128 nX = Gather(table.mNX, quads), nY = Gather(table.mNY, quads), nZ = Gather(table.mNZ, quads);
+			__m128 flip = _mm_and_ps(_mm_cmplt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, nX), _mm_mul_ps(dY, nY)), _mm_mul_ps(dZ, nZ)), zero), sign);
+
+			nX = _mm_xor_ps(nX, flip);
+			nY = _mm_xor_ps(nY, flip);
+			nZ = _mm_xor_ps(nZ, flip);
+
+			// Find where the sphere's motion takes it into the plane.
+			__m128 fDN = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, nX), _mm_mul_ps(dY, nY)), _mm_mul_ps(dZ, nZ));
+			__m128 fVN = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, nX), _mm_mul_ps(vy, nY)), _mm_mul_ps(vz, nZ));
+			__m128 bPlaneHit = _mm_cmplt_ps(fVN, epsilon);
+			__m128 bApproach = _mm_and_ps(bPlaneHit, _mm_cmplt_ps(r, fDN));
+			__m128 fT = _mm_and_ps(bApproach, _mm_div_ps(_mm_sub_ps(r, fDN), fVN));
+
+			bPlaneHit = _mm_and_ps(bPlaneHit, _mm_cmpge_ps(fT, zero));
+
+			// Test the point on the plane against each edge.
+			__m128 pX = _mm_sub_ps(_mm_add_ps(cx, _mm_mul_ps(fT, vx)), _mm_mul_ps(r, nX));
+			__m128 pY = _mm_sub_ps(_mm_add_ps(cy, _mm_mul_ps(fT, vy)), _mm_mul_ps(r, nY));
+			__m128 pZ = _mm_sub_ps(_mm_add_ps(cz, _mm_mul_ps(fT, vz)), _mm_mul_ps(r, nZ));
+
+			for (Uint corner = 0; corner < 4; ++corner)
+			{
+				Uint next = (corner + 1) % 4;
+
+				__m128 qX = _mm_sub_ps(Gather(table.mPX[next], quads), pX);
+				__m128 qY = _mm_sub_ps(Gather(table.mPY[next], quads), pY);
+				__m128 qZ = _mm_sub_ps(Gather(table.mPZ[next], quads), pZ);
+				__m128 eX = Gather(table.mEX[corner], quads), eY = Gather(table.mEY[corner], quads), eZ = Gather(table.mEZ[corner], quads);
+				__m128 xX = _mm_sub_ps(_mm_mul_ps(qY, eZ), _mm_mul_ps(qZ, eY));
+				__m128 xY = _mm_sub_ps(_mm_mul_ps(qZ, eX), _mm_mul_ps(qX, eZ));
+				__m128 xZ = _mm_sub_ps(_mm_mul_ps(qX, eY), _mm_mul_ps(qY, eX));
+				__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xX, nX), _mm_mul_ps(xY, nY)), _mm_mul_ps(xZ, nZ));
+
+				bPlaneHit = _mm_and_ps(bPlaneHit, _mm_cmpgt_ps(dot, zero));
+			}
+
+			_mm_storeu_ps(times + index, _mm_or_ps(_mm_and_ps(bPlaneHit, fT), _mm_andnot_ps(bPlaneHit, none)));
+
+			// Quads with edge or vertex tests are redone in full.
+			for (Uint lane = 0; lane < 4; ++lane)
+			{
+				if (!table.mPlaneOnly[quads[lane]]) times[index + lane] = SphereQuadOne(sphere, motion, table, quads[lane]);
+			}
+		}
+#endif
+
+		// Handle any remaining quads one at a time.
+		for (; index < count; ++index) times[index] = SphereQuadOne(sphere, motion, table, indices[index]);
+	}
+
+	/// @brief Finds when a moving sphere first touches one sphere in a batch
+	/// @param sphere Sphere to test
+	/// @param motion Sphere motion
+	/// @param batch Batch of spheres
+	/// @param index Index of batch sphere
+	/// @return Time of contact, or -1 if there is none
+	static float SpheresOne (Sphere const & sphere, Vector const & motion, SphereBatch const & batch, Uint index)
+	{
+		Vector dC = sphere.mCenter - Vector(batch.mCX[index], batch.mCY[index], batch.mCZ[index]);
+		Vector dV = motion - Vector(batch.mVX[index], batch.mVY[index], batch.mVZ[index]);
+
+		float fT, rSum = sphere.mRadius + batch.mR[index];
+
+		return BQF(dV * dV, dV * dC, dC * dC - rSum * rSum, fT) ? fT : -1.0f;
+	}
+
+	/// @brief Finds when a moving sphere first touches each sphere in a batch
+	/// @param sphere Sphere to test
+	/// @param motion Sphere motion
+	/// @param batch Batch of spheres
+	/// @param times [out] Per batch sphere, time of contact, or -1 if there is none
+	/// @note The times follow the same arithmetic as Spheres, four spheres at a time when
+	///       SSE2 is available; hits must still be checked against the limit
+	void SpheresBatch (Sphere const & sphere, Vector const & motion, SphereBatch const & batch, float * times)
+	{
+		Uint count = batch.GetCount(), index = 0;
+
+#ifdef DYNAMICS_SSE2
+		__m128 cx = _mm_set1_ps(sphere.mCenter.m[0]), cy = _mm_set1_ps(sphere.mCenter.m[1]), cz = _mm_set1_ps(sphere.mCenter.m[2]);
+		__m128 vx = _mm_set1_ps(motion.m[0]), vy = _mm_set1_ps(motion.m[1]), vz = _mm_set1_ps(motion.m[2]);
+		__m128 r = _mm_set1_ps(sphere.mRadius);
+		__m128 sign = _mm_set1_ps(-0.0f), epsilon = _mm_set1_ps(1e-6f), zero = _mm_setzero_ps(), none = _mm_set1_ps(-1.0f);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			// Compute the binary quadratic form coefficients, as in Spheres.
+			__m128 dCX = _mm_sub_ps(cx, _mm_loadu_ps(&batch.mCX[index]));
+			__m128 dCY = _mm_sub_ps(cy, _mm_loadu_ps(&batch.mCY[index]));
+			__m128 dCZ = _mm_sub_ps(cz, _mm_loadu_ps(&batch.mCZ[index]));
+			__m128 dVX = _mm_sub_ps(vx, _mm_loadu_ps(&batch.mVX[index]));
+			__m128 dVY = _mm_sub_ps(vy, _mm_loadu_ps(&batch.mVY[index]));
+			__m128 dVZ = _mm_sub_ps(vz, _mm_loadu_ps(&batch.mVZ[index]));
+			__m128 rSum = _mm_add_ps(r, _mm_loadu_ps(&batch.mR[index]));
+
+			__m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dVX, dVX), _mm_mul_ps(dVY, dVY)), _mm_mul_ps(dVZ, dVZ));
+			__m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dVX, dCX), _mm_mul_ps(dVY, dCY)), _mm_mul_ps(dVZ, dCZ));
+			__m128 c = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dCX, dCX), _mm_mul_ps(dCY, dCY)), _mm_mul_ps(dCZ, dCZ));
+
+			c = _mm_sub_ps(c, _mm_mul_ps(rSum, rSum));
+
+			// Solve the form, as in BQF, masking out lanes without a solution.
+			__m128 term = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+			__m128 valid = _mm_and_ps(_mm_cmpge_ps(_mm_andnot_ps(sign, a), epsilon), _mm_cmpge_ps(term, zero));
+			__m128 discriminant = _mm_sqrt_ps(_mm_max_ps(term, zero));
+			__m128 negB = _mm_xor_ps(b, sign);
+			__m128 t1 = _mm_div_ps(_mm_sub_ps(negB, discriminant), a);
+			__m128 t2 = _mm_div_ps(_mm_add_ps(negB, discriminant), a);
+			__m128 bLow = _mm_cmplt_ps(t1, zero);
+			__m128 t = _mm_or_ps(_mm_and_ps(bLow, t2), _mm_andnot_ps(bLow, t1));
+
+			valid = _mm_and_ps(valid, _mm_cmpge_ps(t, zero));
+
+			_mm_storeu_ps(times + index, _mm_or_ps(_mm_and_ps(valid, t), _mm_andnot_ps(valid, none)));
+		}
+#endif
+
+		// Handle any remaining spheres one at a time.
+		for (; index < count; ++index) times[index] = SpheresOne(sphere, motion, batch, index);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "Dynamics.h"
+#include <cmath>
+
+namespace Dynamics
+{
+	/// @brief Adds a hit, if it precedes the current one
+	/// @param contact Point of collision contact
+	/// @param normal Normal at collision point
+	/// @param fT Time of hit
+	void Hit::AddHit (Vector const & contact, Vector const & normal, float fT)
+	{
+		if (fT >= mT) return;
+
+		mContact = contact;
+		mNormal = normal;
+		mT = fT;
+
+		mInit = true;
+	}
+
+	/// @brief Solves a binary quadratic form, a * t^2 + 2 * b * t + c = 0
+	/// @param a Quadratic coefficient
+	/// @param b Half the linear coefficient
+	/// @param c Constant coefficient
+	/// @param t [out] Least non-negative solution
+	/// @return If true, a solution was found
+	bool BQF (float a, float b, float c, float & t)
+	{
+		if (fabsf(a) < 1e-6f) return false;
+
+		float term = b * b - a * c;
+
+		if (term < 0.0f) return false;
+
+		float discriminant = sqrtf(term);
+
+		t = (-b - discriminant) / a;
+
+		if (t < 0.0f) t = (-b + discriminant) / a;
+
+		return t >= 0.0f;
+	}
+
+	/// @brief Finds when a moving sphere first touches a quad
+	/// @param sphere Sphere to test
+	/// @param quad Quad to test
+	/// @param motion Sphere motion
+	/// @param hit [in-out] Unused hit storage; its time is the limit
+	/// @return If true, a hit was found before the limit
+	bool SphereQuad (Sphere const & sphere, Quad const & quad, Vector const & motion, Hit & hit)
+	{
+		float fLimit = hit.mT;
+
+		Vector V = motion, N = quad.mNormal, P = quad.mCorners[0];
+
+		// Switch the normal's sense if the sphere is on the opposite side of the quad.
+		Vector D = sphere.mCenter - P;
+
+		if (D * N < 0.0f) N = -N;
+
+		// If the sphere's motion is parallel to / away from the plane, or will not switch
+		// sides before hitting its goal, trivially reject it if it is not near the plane.
+		float fDN = D * N, fVN = V * N;
+
+		bool bPlaneHit = fVN < -1e-6f;
+
+		if (!bPlaneHit && fDN > sphere.mRadius + 1e-3f) return false;
+		if (fDN + fLimit * fVN > sphere.mRadius + 1e-3f) return false;
+
+		// Determine if and when the sphere will intersect the quad plane in this step. If the
+		// sphere is penetrating or touching, this is instant.
+		float fT = bPlaneHit && sphere.mRadius < fDN ? (sphere.mRadius - fDN) / fVN : 0.0f;
+
+		bPlaneHit &= fT >= 0.0f;
+
+		float fV2 = V * V, fR2 = sphere.mRadius * sphere.mRadius;
+
+		// If there is nothing to test, quit now.
+		if (!bPlaneHit && quad.mETest.none() && quad.mVTest.none()) return false;
+
+		// Move the center along its heading up to the collision time. From here, step from the
+		// center to the point of intersection on the sphere.
+		Vector C = sphere.mCenter + fT * V - sphere.mRadius * N;
+
+		// Iterate through the four corners, forming an edge with the corner prior to each.
+		for (Uint index = 0; index < 4; ++index)
+		{
+			Vector Q = quad.mCorners[(index + 1) % 4];
+			Vector edge = Q - P;
+
+			// Form a ray from the corner to the point on the plane.  If its cross product with
+			// the edge points away from the surface normal, the point is outside the quad.
+			bPlaneHit &= ((Q - C) ^ edge) * N > 0.0f;
+
+			// Test the sphere against the current edge.
+			float fDV = D * V, fD2 = D * D, fT;
+
+			if (quad.mETest[index])
+			{
+				Vector EU = ~edge;
+
+				float fEV = EU * V, fED = EU * D;
+
+				if (BQF(fV2 - fEV * fEV, V * D - fED * fEV, fD2 - fED * fED - fR2, fT))
+				{
+					Vector C = sphere.mCenter + fT * V;
+
+					float fOffset = (C - P) * EU;
+
+					// Verify that the contact lies along the edge.
+					if (fOffset > 0.0f && fOffset < edge.length())
+					{
+						Vector contact = P + fOffset * EU;
+
+						hit.AddHit(contact, C - contact, fT);
+					}
+				}
+			}
+
+			// Test the sphere against the current vertex.
+			if (quad.mVTest[index] && BQF(fV2, fDV, fD2 - fR2, fT)) hit.AddHit(P, D + fT * V, fT);
+
+			P = Q;
+			D = sphere.mCenter - P;
+		}
+
+		// Load the point on the plane if it lies within the quad.
+		if (bPlaneHit) hit.AddHit(C, N, fT);
+
+		// Normalize the first hit's normal.
+		if (hit.mInit) hit.mNormal = ~hit.mNormal;
+
+		return hit.mInit;
+	}
+
+	/// @brief Finds when two moving spheres first touch
+	/// @param s1 First sphere
+	/// @param s2 Second sphere
+	/// @param v1 First sphere motion
+	/// @param v2 Second sphere motion
+	/// @param hit [in-out] Unused hit storage; its time is the limit
+	/// @return If true, a hit was found before the limit
+	bool Spheres (Sphere const & s1, Sphere const & s2, Vector const & v1, Vector const & v2, Hit & hit)
+	{
+		// Compute the coefficients for the sphere collision equation, which is a binary
+		// quadratic form. Check whether the spheres will intersect in this time step.
+		Vector dC = s1.mCenter - s2.mCenter, dV = v1 - v2;
+
+		float fT, rSum = s1.mRadius + s2.mRadius;
+
+		if (BQF(dV * dV, dV * dC, dC * dC - rSum * rSum, fT) && fT < hit.mT)
+		{
+			// Compute the vector between the new centers, following it to the collision point.
+			// Normalize it to acquire the collision normal.
+			dC = s1.mRadius / rSum * (dC + fT * dV);
+
+			hit.AddHit(s1.mCenter + fT * v1 - dC, dC / s1.mRadius, fT);
+
+			return true;
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
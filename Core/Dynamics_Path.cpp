@@ -0,0 +1,529 @@
+#include "Dynamics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Dynamics
+{
+	/// @brief Gets a point along an arc
+	/// @param P Start of arc
+	/// @param V Motion at start of arc
+	/// @param A Acceleration along arc
+	/// @param fT Time along arc
+	/// @return Point at given time
+	static Vector ArcPoint (Vector const & P, Vector const & V, Vector const & A, float fT)
+	{
+		return P + fT * V + (0.5f * fT * fT) * A;
+	}
+
+	/// @brief Finds when a sphere moving along an arc first touches a plane
+	/// @param P Start of arc
+	/// @param V Motion at start of arc
+	/// @param A Acceleration along arc
+	/// @param N Plane normal, on the side of the sphere
+	/// @param fD Plane distance along the normal, offset by the sphere radius
+	/// @param fLimit Time limit of arc
+	/// @param fT [out] On success, time of contact
+	/// @return If true, the sphere touches the plane before the limit
+	static bool ArcPlane (Vector const & P, Vector const & V, Vector const & A, Vector const & N, float fD, float fLimit, float & fT)
+	{
+		float a = 0.5f * (A * N), b = V * N, c = P * N - fD;
+
+		// If the sphere is penetrating or touching, this is instant.
+		if (c <= 0.0f)
+		{
+			fT = 0.0f;
+
+			return true;
+		}
+
+		// Flat arcs reduce to a line. Otherwise, keep the leading coefficient positive, so
+		// that the earlier root is tried first.
+		if (fabsf(a) < 1e-6f)
+		{
+			if (b > -1e-6f) return false;
+
+			fT = -c / b;
+		}
+
+		else
+		{
+			if (a < 0.0f) a = -a, b = -b, c = -c;
+
+			if (!BQF(a, 0.5f * b, c, fT)) return false;
+		}
+
+		return fT <= fLimit;
+	}
+
+	/// @brief Finds when an arc passes closest to a point
+	/// @param P Start of arc
+	/// @param V Motion at start of arc
+	/// @param A Acceleration along arc
+	/// @param T Point to approach
+	/// @param fSpan Time span of arc
+	/// @return Time of closest approach, within the span
+	/// @note The span is sampled, then the nearest sample is refined by Newton's method; the
+	///       refinement is only kept if it comes closer
+	static float ArcClosest (Vector const & P, Vector const & V, Vector const & A, Vector const & T, float fSpan)
+	{
+		const Uint Samples = 8;
+
+		float fBest = 0.0f, fBestD2 = 0.0f;
+
+		for (Uint i = 0; i <= Samples; ++i)
+		{
+			float fT = fSpan * float(i) / Samples;
+
+			Vector d = ArcPoint(P, V, A, fT) - T;
+
+			if (0 == i || d * d < fBestD2) fBest = fT, fBestD2 = d * d;
+		}
+
+		// f(t) = |X(t) - T|^2 / 2
+		// f'(t) = (X(t) - T) . X'(t)
+		// f''(t) = X'(t) . X'(t) + (X(t) - T) . A
+		float fT = fBest;
+
+		for (Uint i = 0; i < 4; ++i)
+		{
+			Vector d = ArcPoint(P, V, A, fT) - T, dv = V + fT * A;
+
+			float fD2 = dv * dv + d * A;
+
+			if (fD2 <= 0.0f) break;
+
+			fT = std::max(0.0f, std::min(fT - (d * dv) / fD2, fSpan));
+		}
+
+		Vector d = ArcPoint(P, V, A, fT) - T;
+
+		return d * d < fBestD2 ? fT : fBest;
+	}
+
+	/// @brief Extends a path from its last state, bouncing off the walls under its force
+	/// @param path [in-out] Path to extend
+	/// @param fTime Time to predict up to, from the start of the path
+	/// @param step Time step; each step's arc is swept against the walls in one query
+	/// @param limit Count of bounces after which the rest of a step is dropped
+	/// @param fRestitution Restitution factor of a bounce
+	/// @param fEpsilon Displacement away from a wall after bouncing off it
+	/// @param candidates [out] Walls near each arc, as working storage
+	/// @param hits [out] Hits along each arc, as working storage
+	/// @note Between bounces the object follows the exact arc under the force; hits against
+	///       wall faces are solved along the arc, while those against edges and corners are
+	///       found along its chord, which strays from the arc by at most its sag
+	void World::ExtendPath (Path & path, float fTime, float step, Uint limit, float fRestitution, float fEpsilon, std::vector<Uint> & candidates, std::vector<Contact> & hits)
+	{
+		PathState cur = path.mStates.back();
+
+		Vector A = path.mForce;
+
+		float fR = path.mRadius, fSag = 0.125f * A.length() * step * step;
+
+		for (fTime -= cur.mTime; fTime > 0.0f; fTime -= step)
+		{
+			float fSpan = std::min(step, fTime);
+
+			for (Uint run = 0; fSpan > 0.0f && run != limit; ++run)
+			{
+				// Gather the walls near the arc, bounding it by the chord swept by a sphere that
+				// is padded by the sag.
+				Vector P = cur.mPosition, V = cur.mMotion;
+				Vector chord = (ArcPoint(P, V, A, fSpan) - P) / fSpan;
+
+				mTree.Query(Box(Sphere(P, fR + fSag), chord, fSpan), candidates);
+
+				std::sort(candidates.begin(), candidates.end());
+
+				// Find the earliest set of simultaneous hits along the arc, as in a step.
+				float fFirst = fSpan;
+
+				hits.clear();
+
+				for (Uint i = 0; i < candidates.size(); ++i)
+				{
+					Wall & wall = mWalls[candidates[i]];
+
+					if (!Tests(mWallMaterials, path.mType, wall.mType)) continue;
+
+					Hit hit(fFirst + fSimultaneity);
+
+					if (!SphereQuad(Sphere(P, fR), wall.mQuad, chord, hit)) continue;
+
+					// A face hit is found again along the arc, and may turn out to be missed.
+					Vector N = ~hit.mNormal;
+
+					float fT = hit.mT;
+
+					if (fabsf(N * wall.mQuad.mNormal) > 0.999f && !ArcPlane(P, V, A, N, N * wall.mQuad.mCorners[0] + fR, fFirst + fSimultaneity, fT)) continue;
+
+					if (fabsf(fT - fFirst) > fSimultaneity)
+					{
+						hits.clear();
+
+						fFirst = fT;
+					}
+
+					Contact contact;
+
+					contact.mObject = 0;
+					contact.mOther = candidates[i];
+					contact.mWall = true;
+					contact.mPoint = ArcPoint(P, V, A, fT) - fR * N;
+					contact.mNormal = N;
+
+					hits.push_back(contact);
+				}
+
+				// Follow the arc up to the hits, if any.
+				cur.mPosition = ArcPoint(P, V, A, fFirst);
+				cur.mMotion = V + fFirst * A;
+				cur.mTime += fFirst;
+
+				fSpan -= fFirst;
+
+				// Bounce off each wall that was hit, adding the new state to the path.
+				for (Uint i = 0; i < hits.size(); ++i)
+				{
+					Vector const & N = hits[i].mNormal;
+
+					if (cur.mMotion * cur.mMotion > 0.0f) cur.mMotion = (cur.mMotion - 2.0f * (N * cur.mMotion) * N) * fRestitution;
+
+					cur.mPosition = cur.mPosition + fEpsilon * N;
+
+					path.mStates.push_back(cur);
+				}
+
+				if (hits.empty()) break;
+			}
+		}
+
+		path.mStates.push_back(cur);
+	}
+
+	/// @brief Predicts the path of an object, reusing what remains valid of an earlier one
+	/// @param path [in-out] Path to update
+	/// @param sphere Object bounding sphere
+	/// @param motion Object motion
+	/// @param force Force applied to the object over unit time
+	/// @param type Object material type; only walls it is tested against are bounced off
+	/// @param fTime Time to predict ahead
+	/// @param step Time step; each step's arc is swept against the walls in one query
+	/// @param limit Count of bounces after which the rest of a step is dropped
+	/// @param fRestitution Restitution factor of a bounce
+	/// @param fEpsilon Displacement away from a wall after bouncing off it
+	/// @param fTolerance Distance within which the object is taken to be on the old path
+	/// @return Count of states reused from the old path
+	/// @note The old path is cut back to the first arc near a changed wall. If the object is
+	///       still on what is left, the path is restarted from where it is along it and only
+	///       extended; otherwise, it is predicted anew
+	Uint World::PredictPath (Path & path, Sphere const & sphere, Vector const & motion, Vector const & force, Uint type, float fTime, float step, Uint limit, float fRestitution, float fEpsilon, float fTolerance)
+	{
+		FPState state(mDeterministic);
+
+		UpdateWalls();
+
+		// Drop the old path if it was predicted for another object or under other materials.
+		// If only one change to the walls was missed, cut the path back to the first arc
+		// that passes near a changed wall; otherwise, the changes are not known.
+		bool bSame = path.mWorld == this && path.mType == type && path.mRadius == sphere.mRadius && path.mMaterialRevision == mMaterialRevision;
+
+		for (int k = 0; bSame && k < 3; ++k) bSame = path.mForce.m[k] == force.m[k];
+
+		bool bCut = false;
+
+		if (!bSame || path.mWallRevision + 1 < mWallRevision) path.mStates.clear();
+
+		else if (path.mWallRevision != mWallRevision)
+		{
+			Vector A = path.mForce;
+
+			for (Uint i = 0; i + 1 < path.mStates.size(); ++i)
+			{
+				PathState & S = path.mStates[i];
+
+				float fSpan = path.mStates[i + 1].mTime - S.mTime, fSag = 0.125f * A.length() * fSpan * fSpan;
+
+				if (fSpan <= 0.0f) continue;
+
+				Box box(Sphere(S.mPosition, sphere.mRadius + fSag), (ArcPoint(S.mPosition, S.mMotion, A, fSpan) - S.mPosition) / fSpan, fSpan);
+
+				Uint j = 0;
+
+				while (j < mChangedBoxes.size() && !box.Overlaps(mChangedBoxes[j])) ++j;
+
+				if (j == mChangedBoxes.size()) continue;
+
+				path.mStates.resize(i + 1);
+
+				bCut = true;
+
+				break;
+			}
+		}
+
+		path.mWorld = this;
+		path.mForce = force;
+		path.mRadius = sphere.mRadius;
+		path.mType = type;
+		path.mWallRevision = mWallRevision;
+		path.mMaterialRevision = mMaterialRevision;
+
+		// Restart the path from where the object is along it, if it can be found; the rest of
+		// the path is still good, since nothing has changed in its way.
+		Uint index;
+		float fT;
+
+		PathState cur;
+
+		cur.mPosition = sphere.mCenter;
+		cur.mMotion = motion;
+
+		if (path.Locate(sphere.mCenter, motion, fTolerance, index, fT))
+		{
+			fT += path.mStates[index].mTime;
+
+			path.mStates.erase(path.mStates.begin(), path.mStates.begin() + index);
+
+			for (Uint i = 1; i < path.mStates.size(); ++i) path.mStates[i].mTime -= fT;
+		}
+
+		else path.mStates.clear();
+
+		Uint reused = Uint(path.mStates.size());
+
+		if (path.mStates.empty()) path.mStates.push_back(cur);
+
+		else path.mStates.front() = cur;
+
+		path.mStates.front().mTime = 0.0f;
+
+		// Trim the path to the time given, or extend it up to then. Unless the path was cut
+		// back, it closes with an end state, so resume from the state before that instead.
+		if (path.mStates.back().mTime >= fTime && path.mStates.size() > 1) path.Truncate(fTime);
+
+		else
+		{
+			if (!bCut && path.mStates.size() > 1) path.mStates.pop_back();
+
+			ExtendPath(path, fTime, step, limit, fRestitution, fEpsilon, mPathCandidates, mPathHits);
+		}
+
+		return reused;
+	}
+
+	/// @brief Shot candidates being planned, as handed to each lane
+	struct ShotPlan {
+		World * mWorld;	///< World in which shots are planned
+		ShotQuery const * mQuery;	///< Launch being planned
+		Shot * mShots;	///< Candidates, which receive their results
+		Uint mCount;///< Count of candidates
+		Uint mLaneCount;///< Count of lanes
+	};
+
+	/// @brief Plans the shots of a lane
+	/// @param pPlan Plan being run
+	/// @param lane Lane index
+	/// @note Each lane takes every so many candidates, spreading long and short paths evenly
+	void World::ShotJob (void * pPlan, Uint lane)
+	{
+		ShotPlan * pP = static_cast<ShotPlan*>(pPlan);
+
+		// Each thread has its own floating-point state, so pin it here as well.
+		FPState state(pP->mWorld->mDeterministic);
+
+		for (Uint i = lane; i < pP->mCount; i += pP->mLaneCount) pP->mWorld->PlanShot(pP->mWorld->mShotLanes[lane], *pP->mQuery, pP->mShots[i]);
+	}
+
+	/// @brief Predicts the path of a shot and scores it
+	/// @param lane Lane planning the shot, whose working state is used
+	/// @param query Launch being planned
+	/// @param shot [in-out] Shot, with launch speed and angle; receives its results
+	/// @note The shot is launched toward the target; its cost is its closest approach to it
+	/// @note Only the lane and shot are modified, so that lanes may be planned concurrently
+	void World::PlanShot (ShotLane & lane, ShotQuery const & query, Shot & shot)
+	{
+		Path & path = lane.mPath;
+
+		Vector A = query.mForce, T = query.mTarget, D = (T - query.mSphere.mCenter).XZ();
+
+		if (D * D > 0.0f) D = ~D;
+
+		else D = Vector(0.0f, 0.0f, 1.0f);
+
+		// Launch the object and predict its path.
+		PathState start;
+
+		start.mPosition = query.mSphere.mCenter;
+		start.mMotion = D * (shot.mSpeed * cosf(shot.mAngle)) + Vector(0.0f, shot.mSpeed * sinf(shot.mAngle), 0.0f);
+		start.mTime = 0.0f;
+
+		path.mStates.clear();
+		path.mStates.push_back(start);
+
+		path.mForce = A;
+		path.mRadius = query.mSphere.mRadius;
+		path.mType = query.mType;
+
+		ExtendPath(path, query.mTime, query.mStep, query.mLimit, query.mRestitution, query.mEpsilon, lane.mCandidates, lane.mHits);
+
+		// Follow each arc for its peak and closest approach to the target. The last state
+		// closes the path, so its arc is empty.
+		shot.mBounces = Uint(path.mStates.size()) - 2;
+		shot.mPeak = start.mPosition.m[1];
+
+		for (Uint i = 0; i < path.mStates.size(); ++i)
+		{
+			PathState const & S = path.mStates[i];
+
+			float fSpan = i + 1 < path.mStates.size() ? path.mStates[i + 1].mTime - S.mTime : 0.0f;
+
+			shot.mPeak = std::max(shot.mPeak, S.mPosition.m[1]);
+
+			if (A.m[1] < 0.0f && S.mMotion.m[1] > 0.0f)
+			{
+				float fT = -S.mMotion.m[1] / A.m[1];
+
+				if (fT < fSpan) shot.mPeak = std::max(shot.mPeak, ArcPoint(S.mPosition, S.mMotion, A, fT).m[1]);
+			}
+
+			float fT = ArcClosest(S.mPosition, S.mMotion, A, T, fSpan), fDistance = (ArcPoint(S.mPosition, S.mMotion, A, fT) - T).length();
+
+			if (0 == i || fDistance < shot.mDistance)
+			{
+				shot.mDistance = fDistance;
+				shot.mTime = S.mTime + fT;
+			}
+		}
+
+		shot.mCost = shot.mDistance;
+	}
+
+	/// @brief Plans shots over a grid of launch speeds and angles
+	/// @param query Launch to plan from, and how its candidates are predicted
+	/// @param speeds Launch speeds
+	/// @param nspeeds Count of speeds
+	/// @param angles Launch angles
+	/// @param nangles Count of angles
+	/// @param shots [out] Shots that stay below the ceiling, by speed, then by angle
+	/// @note Each candidate's path is predicted as in PredictPath, with candidates spread
+	///       across the worker threads; the results do not depend on the thread count
+	void World::PlanShots (ShotQuery const & query, float const * speeds, Uint nspeeds, float const * angles, Uint nangles, std::vector<Shot> & shots)
+	{
+		FPState state(mDeterministic);
+
+		UpdateWalls();
+
+		Uint count = nspeeds * nangles, nlanes = std::min(GetWorkerCount() + 1, count);
+
+		shots.resize(count);
+
+		if (0 == count) return;
+
+		for (Uint i = 0; i < count; ++i)
+		{
+			shots[i].mSpeed = speeds[i / nangles];
+			shots[i].mAngle = angles[i % nangles];
+		}
+
+		// Predict each candidate's path on the workers.
+		if (mShotLanes.size() < nlanes) mShotLanes.resize(nlanes);
+
+		ShotPlan plan = { this, &query, &shots[0], count, nlanes };
+
+		mWorkers.Run(ShotJob, &plan, nlanes);
+
+		// Drop shots that climb too high.
+		Uint n = 0;
+
+		for (Uint i = 0; i < count; ++i)
+		{
+			if (shots[i].mPeak <= query.mCeiling) shots[n++] = shots[i];
+		}
+
+		shots.resize(n);
+	}
+
+	/// @brief Gets the state at a given time along the path
+	/// @param fTime Time from the start of the path
+	/// @return State at the given time, following the arc it falls on
+	/// @note Times outside the path follow the first or last arc
+	PathState Path::GetState (float fTime) const
+	{
+		PathState state;
+
+		state.mTime = fTime;
+
+		if (mStates.empty()) return state;
+
+		// Find the last state at or before the time, and follow its arc.
+		Uint lo = 0, hi = Uint(mStates.size());
+
+		while (hi - lo > 1)
+		{
+			Uint mid = (lo + hi) / 2;
+
+			if (mStates[mid].mTime <= fTime) lo = mid;
+
+			else hi = mid;
+		}
+
+		PathState const & S = mStates[lo];
+
+		float fT = fTime - S.mTime;
+
+		state.mPosition = ArcPoint(S.mPosition, S.mMotion, mForce, fT);
+		state.mMotion = S.mMotion + fT * mForce;
+
+		return state;
+	}
+
+	/// @brief Finds where an object is along the path
+	/// @param position Object position
+	/// @param motion Object motion
+	/// @param fTolerance Distance within which the position and motion must match the path's
+	/// @param index [out] On success, index of the state that begins the arc the object is on
+	/// @param fT [out] On success, time along the arc
+	/// @return If true, the object was found on the path
+	/// @note Along an arc the time follows from the change in motion, or from the change in
+	///       position if there is no force; the first matching arc is used
+	bool Path::Locate (Vector const & position, Vector const & motion, float fTolerance, Uint & index, float & fT) const
+	{
+		Vector A = mForce;
+
+		float fA2 = A * A, fT2 = fTolerance * fTolerance;
+
+		for (index = 0; index + 1 < mStates.size(); ++index)
+		{
+			PathState const & S = mStates[index];
+
+			float fSpan = mStates[index + 1].mTime - S.mTime, fV2 = S.mMotion * S.mMotion;
+
+			if (fA2 > 1e-12f) fT = ((motion - S.mMotion) * A) / fA2;
+
+			else fT = fV2 > 1e-12f ? ((position - S.mPosition) * S.mMotion) / fV2 : 0.0f;
+
+			fT = std::max(0.0f, std::min(fT, fSpan));
+
+			Vector dp = ArcPoint(S.mPosition, S.mMotion, A, fT) - position, dv = S.mMotion + fT * A - motion;
+
+			if (dp * dp <= fT2 && dv * dv <= fT2) return true;
+		}
+
+		return false;
+	}
+
+	/// @brief Cuts the path off at a given time
+	/// @param fTime Time from the start of the path
+	/// @note The state at the given time becomes the end state
+	void Path::Truncate (float fTime)
+	{
+		if (mStates.empty()) return;
+
+		PathState end = GetState(fTime);
+
+		while (mStates.size() > 1 && mStates.back().mTime >= fTime) mStates.pop_back();
+
+		mStates.push_back(end);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,386 @@
+#include "Dynamics.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_IX86)
+	#define DYNAMICS_X87
+	#include <float.h>
+#endif
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define DYNAMICS_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace Dynamics
+{
+	/// @brief Signature at the head of a step log
+	static const char Signature[] = "DYNL";
+
+	/// @brief Step log format version
+	static const Uint32 Version = 2;
+
+	/// @brief Step log record tags
+	enum {
+		eMaterials = 'M',	///< Material tables
+		eStep = 'S',///< Step inputs and results
+		eWalls = 'W'///< Wall set
+	};
+
+	/// @brief Writes a value to a log
+	/// @param fp Log file
+	/// @param value Value to write
+	template<typename T> static void Put (FILE * fp, T const & value)
+	{
+		fwrite(&value, sizeof(T), 1, fp);
+	}
+
+	/// @brief Reads a value from a log
+	/// @param fp Log file
+	/// @param value [out] On success, value read
+	/// @return If true, the value was read
+	template<typename T> static bool Get (FILE * fp, T & value)
+	{
+		return fread(&value, sizeof(T), 1, fp) == 1;
+	}
+
+	/// @brief Writes a vector to a log
+	/// @param fp Log file
+	/// @param v Vector to write
+	static void PutVector (FILE * fp, Vector const & v)
+	{
+		fwrite(v.m, sizeof(float), 3, fp);
+	}
+
+	/// @brief Reads a vector from a log
+	/// @param fp Log file
+	/// @param v [out] On success, vector read
+	/// @return If true, the vector was read
+	static bool GetVector (FILE * fp, Vector & v)
+	{
+		return fread(v.m, sizeof(float), 3, fp) == 3;
+	}
+
+	/// @brief Indicates whether two floats are bit-for-bit identical
+	/// @param f1 First float
+	/// @param f2 Second float
+	/// @return If true, the floats are identical
+	static bool Exact (float f1, float f2)
+	{
+		return memcmp(&f1, &f2, sizeof(float)) == 0;
+	}
+
+	/// @brief Constructs an FPState object
+	/// @param bPin If true, pin single precision, round-to-nearest, and gradual underflow
+	/// @note On x87, intermediates are otherwise kept at a precision that varies by build,
+	///       while SSE flush modes may be left set by other libraries
+	FPState::FPState (bool bPin) : mControl(0), mCSR(0), mPinned(bPin)
+	{
+		if (!bPin) return;
+
+	#ifdef DYNAMICS_X87
+		_controlfp_s(&mControl, 0, 0);
+
+		unsigned int control;
+
+		_controlfp_s(&control, _PC_24 | _RC_NEAR | _DN_SAVE, _MCW_PC | _MCW_RC | _MCW_DN);
+	#endif
+	#ifdef DYNAMICS_SSE
+		mCSR = _mm_getcsr();
+
+		_mm_setcsr((mCSR & ~(_MM_ROUND_MASK | _MM_FLUSH_ZERO_MASK | 0x0040)) | _MM_ROUND_NEAREST | _MM_FLUSH_ZERO_OFF);
+	#endif
+	}
+
+	/// @brief Destructs an FPState object
+	/// @note If the state was pinned, the saved state is restored
+	FPState::~FPState (void)
+	{
+		if (!mPinned) return;
+
+	#ifdef DYNAMICS_X87
+		unsigned int control;
+
+		_controlfp_s(&control, mControl, _MCW_PC | _MCW_RC | _MCW_DN);
+	#endif
+	#ifdef DYNAMICS_SSE
+		_mm_setcsr(mCSR);
+	#endif
+	}
+
+	/// @brief Replays a step log and checks that the results come out the same
+	/// @param name Log file name
+	/// @param steps [out] Count of steps replayed
+	/// @param mismatch [out] Number of the first step whose results differ, or 0 if none do
+	/// @return If true, the log was replayed to its end
+	/// @note The world's objects, walls, and materials are replaced by those in the log
+	bool World::Replay (char const * name, Uint & steps, Uint & mismatch)
+	{
+		steps = mismatch = 0;
+
+		StopLog();
+
+		FILE * fp = fopen(name, "rb");
+
+		if (0 == fp) return false;
+
+		// Check the header, and adopt the mode that the log was recorded in.
+		char signature[4];
+		Uint32 version;
+		Uint8 bDeterministic;
+
+		bool bOK = fread(signature, 1, 4, fp) == 4 && 0 == memcmp(signature, Signature, 4) && Get(fp, version) && Version == version && Get(fp, bDeterministic);
+
+		if (bOK)
+		{
+			mDeterministic = bDeterministic != 0;
+
+			mMaterials.clear();
+			mWallMaterials.clear();
+
+			mTypeCount = 0;
+
+			ClearObjects();
+			ClearWalls();
+			ResetPrediction();
+		}
+
+		// Feed each record into the world, checking the results of each step.
+		for (Uint8 tag; bOK && Get(fp, tag); )
+		{
+			if (eWalls == tag)
+			{
+				Uint32 count;
+
+				bOK = Get(fp, count);
+
+				ClearWalls();
+
+				for (Uint32 i = 0; bOK && i < count; ++i)
+				{
+					Vector corners[4], normal;
+					Uint16 etest, vtest;
+					Uint32 type;
+
+					bOK = GetVector(fp, corners[0]) && GetVector(fp, corners[1]) && GetVector(fp, corners[2]) && GetVector(fp, corners[3]);
+					bOK = bOK && GetVector(fp, normal) && Get(fp, etest) && Get(fp, vtest) && Get(fp, type);
+
+					if (!bOK) break;
+
+					Quad quad(corners[0], corners[1], corners[2], corners[3]);
+
+					quad.mNormal = normal;
+					quad.mETest = std::bitset<16>(etest);
+					quad.mVTest = std::bitset<16>(vtest);
+
+					AddWall(quad, type);
+				}
+			}
+
+			else if (eMaterials == tag)
+			{
+				Uint32 count;
+
+				bOK = Get(fp, count) && count > 0;
+
+				if (bOK)
+				{
+					Reserve(count - 1);
+
+					bOK = count == mTypeCount;
+					bOK = bOK && fread(&mMaterials[0], 1, count * count, fp) == count * count;
+					bOK = bOK && fread(&mWallMaterials[0], 1, count * count, fp) == count * count;
+				}
+			}
+
+			else if (eStep == tag)
+			{
+				++steps;
+
+				bOK = ReplayStep(fp);
+
+				if (!bOK && !ferror(fp) && !feof(fp))
+				{
+					if (0 == mismatch) mismatch = steps;
+
+					bOK = true;
+				}
+			}
+
+			else bOK = false;
+		}
+
+		bOK = bOK && feof(fp) != 0;
+
+		fclose(fp);
+
+		return bOK;
+	}
+
+	/// @brief Starts logging each step's inputs and results
+	/// @param name Log file name
+	/// @return If true, the log was opened
+	/// @note Predictions carried over from earlier steps are dropped, so that a replay from
+	///       a fresh world follows the logged steps exactly
+	bool World::StartLog (char const * name)
+	{
+		StopLog();
+
+		mLog = fopen(name, "wb");
+
+		if (0 == mLog) return false;
+
+		fwrite(Signature, 1, 4, mLog);
+
+		Put(mLog, Version);
+		Put(mLog, Uint8(mDeterministic));
+
+		ResetPrediction();
+
+		mLoggedMaterials.clear();
+
+		mLogWalls = true;
+
+		return true;
+	}
+
+	/// @brief Stops logging steps
+	void World::StopLog (void)
+	{
+		if (mLog) fclose(mLog);
+
+		mLog = 0;
+	}
+
+	/// @brief Logs the current step
+	/// @param step Time step given to the step
+	/// @note Walls and materials are logged ahead of the step when they have changed
+	void World::LogStep (float step)
+	{
+		if (mLogWalls)
+		{
+			Put(mLog, Uint8(eWalls));
+			Put(mLog, Uint32(mWalls.size()));
+
+			for (Uint i = 0; i < mWalls.size(); ++i)
+			{
+				Quad const & quad = mWalls[i].mQuad;
+
+				for (int index = 0; index < 4; ++index) PutVector(mLog, quad.mCorners[index]);
+
+				PutVector(mLog, quad.mNormal);
+
+				Put(mLog, Uint16(quad.mETest.to_ulong()));
+				Put(mLog, Uint16(quad.mVTest.to_ulong()));
+				Put(mLog, Uint32(mWalls[i].mType));
+			}
+
+			mLogWalls = false;
+		}
+
+		// Both tables have the same size, so compare them as one.
+		if (mTypeCount > 0 && (mLoggedMaterials.size() != mMaterials.size() * 2 || !std::equal(mMaterials.begin(), mMaterials.end(), mLoggedMaterials.begin()) || !std::equal(mWallMaterials.begin(), mWallMaterials.end(), mLoggedMaterials.begin() + mMaterials.size())))
+		{
+			Put(mLog, Uint8(eMaterials));
+			Put(mLog, Uint32(mTypeCount));
+
+			fwrite(&mMaterials[0], 1, mMaterials.size(), mLog);
+			fwrite(&mWallMaterials[0], 1, mWallMaterials.size(), mLog);
+
+			mLoggedMaterials = mMaterials;
+
+			mLoggedMaterials.insert(mLoggedMaterials.end(), mWallMaterials.begin(), mWallMaterials.end());
+		}
+
+		// Log the objects and step, followed by the results.
+		Put(mLog, Uint8(eStep));
+		Put(mLog, step);
+		Put(mLog, Uint32(mObjects.size()));
+
+		for (Uint i = 0; i < mObjects.size(); ++i)
+		{
+			PutVector(mLog, mObjects[i].mSphere.mCenter);
+			Put(mLog, mObjects[i].mSphere.mRadius);
+			PutVector(mLog, mObjects[i].mMotion);
+			Put(mLog, Uint32(mObjects[i].mType));
+			Put(mLog, Uint32(mObjects[i].mRevision));
+		}
+
+		Put(mLog, mTime);
+		Put(mLog, Uint32(mContacts.size()));
+
+		for (Uint i = 0; i < mContacts.size(); ++i)
+		{
+			Put(mLog, Uint32(mContacts[i].mObject));
+			Put(mLog, Uint32(mContacts[i].mOther));
+			Put(mLog, Uint8(mContacts[i].mWall));
+			PutVector(mLog, mContacts[i].mPoint);
+			PutVector(mLog, mContacts[i].mNormal);
+		}
+	}
+
+	/// @brief Drops the predictions carried over between steps
+	void World::ResetPrediction (void)
+	{
+		mOrder.clear();
+		mPrevObjects.clear();
+		mPrevEvents.clear();
+		mPrevContacts.clear();
+
+		mStuckCount = 0;
+		mPrevTime = 0.0f;
+	}
+
+	/// @brief Replays a logged step
+	/// @param fp Log file, positioned after the step tag
+	/// @return If true, the step was read and its results match
+	/// @note On a mismatch, the rest of the step is still read
+	bool World::ReplayStep (FILE * fp)
+	{
+		float step;
+		Uint32 count;
+
+		if (!Get(fp, step) || !Get(fp, count)) return false;
+
+		ClearObjects();
+
+		for (Uint32 i = 0; i < count; ++i)
+		{
+			Sphere sphere;
+			Vector motion;
+			Uint32 type, revision;
+
+			if (!GetVector(fp, sphere.mCenter) || !Get(fp, sphere.mRadius) || !GetVector(fp, motion) || !Get(fp, type) || !Get(fp, revision)) return false;
+
+			AddObject(sphere, motion, type, revision);
+		}
+
+		FindHits(step);
+
+		// Compare the results, bit for bit.
+		float fTime;
+
+		if (!Get(fp, fTime) || !Get(fp, count)) return false;
+
+		bool bSame = Exact(fTime, mTime) && count == mContacts.size();
+
+		for (Uint32 i = 0; i < count; ++i)
+		{
+			Uint32 object, other;
+			Uint8 bWall;
+			Vector point, normal;
+
+			if (!Get(fp, object) || !Get(fp, other) || !Get(fp, bWall) || !GetVector(fp, point) || !GetVector(fp, normal)) return false;
+
+			if (!bSame) continue;
+
+			Contact const & C = mContacts[i];
+
+			bSame = object == C.mObject && other == C.mOther && (bWall != 0) == C.mWall;
+
+			for (int k = 0; bSame && k < 3; ++k) bSame = Exact(point.m[k], C.mPoint.m[k]) && Exact(normal.m[k], C.mNormal.m[k]);
+		}
+
+		return bSame;
+	}
+}
\ No newline at end of file
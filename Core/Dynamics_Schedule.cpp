@@ -0,0 +1,282 @@
+#include "Dynamics.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace Dynamics
+{
+	/// @brief Allowance for rounding in times carried over between steps
+	static const float fMargin = 1e-4f;
+
+	/// @brief Orders events by key, as generated in test order
+	/// @param e1 First event
+	/// @param e2 Second event
+	/// @return If true, the first event precedes the second
+	static bool Precedes (Event const & e1, Event const & e2)
+	{
+		if (e1.mObject != e2.mObject) return e1.mObject < e2.mObject;
+		if (e1.mWall != e2.mWall) return e2.mWall;
+
+		return e1.mOther < e2.mOther;
+	}
+
+	/// @brief Orders event indices by time, latest first, for use as a heap
+	struct EventLater {
+		std::vector<Event> const & mEvents;	///< Events being ordered
+
+		EventLater (std::vector<Event> const & events) : mEvents(events) {}
+
+		bool operator () (Uint i1, Uint i2) const
+		{
+			return mEvents[i1].mT > mEvents[i2].mT;
+		}
+	};
+
+	/// @brief Carries over an event from the previous step, if possible
+	/// @param event [in-out] Event to find; on success, its time is loaded
+	/// @param prev [in-out] Position in the previous events; advanced past earlier keys
+	/// @return If true, the event was carried over
+	/// @note Both objects in the event must have kept to their course
+	bool World::FindPrevious (Event & event, Uint & prev)
+	{
+		while (prev < mPrevEvents.size() && Precedes(mPrevEvents[prev], event)) ++prev;
+
+		if (prev == mPrevEvents.size() || Precedes(event, mPrevEvents[prev])) return false;
+
+		// Shift the time by the previous step. If the contact was due around then, it must be
+		// found again, since it may have been passed or responded to.
+		float fT = mPrevEvents[prev].mT;
+
+		if (fT >= 0.0f)
+		{
+			fT -= mPrevTime;
+
+			if (fT < fSimultaneity) return false;
+		}
+
+		event.mT = fT;
+		event.mExact = false;
+
+		return true;
+	}
+
+	/// @brief Loads the events for the current step
+	/// @note Objects are split into lanes, weighted by their candidate pairs, that are loaded
+	///       on separate threads; the lanes' events are then joined in order, so the result
+	///       is the same however many threads are used
+	void World::LoadEvents (void)
+	{
+		Uint count = Uint(mObjects.size()), nlanes = GetWorkerCount() + 1;
+
+		if (nlanes > count / LaneSize) nlanes = count / LaneSize;
+		if (nlanes < 1) nlanes = 1;
+
+		mLanes.resize(nlanes);
+
+		// Give each lane about the same share of objects and pairs. The walls are not
+		// counted, since which ones an object reaches is not known until it is loaded.
+		Uint total = count + Uint(mPairs.size()), cur = 0, i = 0;
+
+		for (Uint lane = 0; lane < nlanes; ++lane)
+		{
+			mLanes[lane].mFirst = i;
+
+			Uint share = Uint(double(total) * (lane + 1) / nlanes);
+
+			for (; i < count && (lane + 1 == nlanes || i + cur < share); ++i)
+			{
+				while (cur < mPairs.size() && mPairs[cur].first == i) ++cur;
+			}
+
+			mLanes[lane].mEnd = i;
+		}
+
+		mWorkers.Run(LoadJob, this, nlanes);
+
+		// Join the lanes.
+		mEvents.clear();
+
+		for (Uint lane = 0; lane < nlanes; ++lane) mEvents.insert(mEvents.end(), mLanes[lane].mEvents.begin(), mLanes[lane].mEvents.end());
+	}
+
+	/// @brief Loads the events for a lane of objects
+	/// @param pWorld World being loaded
+	/// @param lane Lane index
+	void World::LoadJob (void * pWorld, Uint lane)
+	{
+		World * pW = static_cast<World*>(pWorld);
+
+		// Each thread has its own floating-point state, so pin it here as well.
+		FPState state(pW->mDeterministic);
+
+		pW->LoadLane(pW->mLanes[lane]);
+	}
+
+	/// @brief Loads the events for a range of objects
+	/// @param lane Lane describing the range, which receives its events
+	/// @note Only the lane is modified, so that lanes may be loaded concurrently
+	void World::LoadLane (Lane & lane)
+	{
+		lane.mEvents.clear();
+
+		// Find where the range begins among the pairs and the previous events.
+		Uint cur = Uint(std::lower_bound(mPairs.begin(), mPairs.end(), std::make_pair(lane.mFirst, Uint(0))) - mPairs.begin());
+		Uint prev = Uint(std::lower_bound(mPrevEvents.begin(), mPrevEvents.end(), Event(lane.mFirst, 0, false), Precedes) - mPrevEvents.begin());
+
+		for (Uint i = lane.mFirst; i < lane.mEnd; ++i)
+		{
+			Object & O1 = mObjects[i];
+
+			// Object-object events. Carry over what is possible and find the remaining contact
+			// times in one batch.
+			lane.mBatch.Clear();
+			lane.mBatched.clear();
+
+			for (; cur < mPairs.size() && mPairs[cur].first == i; ++cur)
+			{
+				Uint j = mPairs[cur].second;
+
+				Object & O2 = mObjects[j];
+
+				if (!Tests(mMaterials, O1.mType, O2.mType)) continue;
+
+				Event event(i, j, false);
+
+				if (mTouched[i] || mTouched[j] || !FindPrevious(event, prev))
+				{
+					lane.mBatch.Add(O2.mSphere, O2.mMotion);
+					lane.mBatched.push_back(Uint(lane.mEvents.size()));
+				}
+
+				lane.mEvents.push_back(event);
+			}
+
+			lane.mTimes.resize(lane.mBatched.size());
+
+			if (!lane.mBatched.empty()) SpheresBatch(O1.mSphere, O1.mMotion, lane.mBatch, &lane.mTimes[0]);
+
+			for (Uint j = 0; j < lane.mBatched.size(); ++j) lane.mEvents[lane.mBatched[j]].mT = lane.mTimes[j];
+
+			// Object-wall events, against the walls the object can reach, likewise.
+			mTree.Query(Box(O1.mSphere, O1.mMotion, mLimit), lane.mCandidates);
+
+			std::sort(lane.mCandidates.begin(), lane.mCandidates.end());
+
+			lane.mBatched.clear();
+			lane.mQuads.clear();
+
+			for (Uint j = 0; j < lane.mCandidates.size(); ++j)
+			{
+				if (!Tests(mWallMaterials, O1.mType, mWalls[lane.mCandidates[j]].mType)) continue;
+
+				Event event(i, lane.mCandidates[j], true);
+
+				if (mTouched[i] || mWallsChanged || !FindPrevious(event, prev))
+				{
+					lane.mQuads.push_back(lane.mCandidates[j]);
+					lane.mBatched.push_back(Uint(lane.mEvents.size()));
+				}
+
+				lane.mEvents.push_back(event);
+			}
+
+			lane.mTimes.resize(lane.mBatched.size());
+
+			if (!lane.mBatched.empty()) SphereQuadsBatch(O1.mSphere, O1.mMotion, mWallTable, &lane.mQuads[0], Uint(lane.mQuads.size()), &lane.mTimes[0]);
+
+			for (Uint j = 0; j < lane.mBatched.size(); ++j) lane.mEvents[lane.mBatched[j]].mT = lane.mTimes[j];
+		}
+	}
+
+	/// @brief Marks the objects that have departed from their predicted course
+	/// @note An object is on course if it kept its type and a known revision since the
+	///       previous step, i.e. it has only moved along its motion; if the object set has
+	///       changed, all objects are marked
+	void World::MarkTouched (void)
+	{
+		if (mPrevObjects.size() != mObjects.size())
+		{
+			mTouched.assign(mObjects.size(), 1);
+
+			return;
+		}
+
+		mTouched.resize(mObjects.size());
+
+		for (Uint i = 0; i < mObjects.size(); ++i)
+		{
+			Object & O = mObjects[i], & P = mPrevObjects[i];
+
+			mTouched[i] = 0 == O.mRevision || O.mRevision != P.mRevision || O.mType != P.mType;
+		}
+	}
+
+	/// @brief Computes exact times for the events that may decide the earliest hits
+	/// @param fLimit Time limit of step
+	/// @note Events are taken from a queue in order of time, while they might fall within
+	///       the simultaneity window of the earliest hit so far; those left behind cannot
+	///       affect this step's hits
+	void World::ResolveEvents (float fLimit)
+	{
+		mQueue.clear();
+
+		for (Uint i = 0; i < mEvents.size(); ++i)
+		{
+			if (mEvents[i].mT >= 0.0f && mEvents[i].mT < fLimit + fMargin) mQueue.push_back(i);
+		}
+
+		EventLater later(mEvents);
+
+		std::make_heap(mQueue.begin(), mQueue.end(), later);
+
+		// Only sphere and plane hits are certain to register once under the limit, so only
+		// they narrow the window. Events later than two windows past the earliest of these
+		// cannot be in, or reset, the final set.
+		float fEarliest = fLimit;
+
+		while (!mQueue.empty() && mEvents[mQueue.front()].mT <= fEarliest + 2.0f * fSimultaneity + fMargin)
+		{
+			Event & event = mEvents[mQueue.front()];
+
+			std::pop_heap(mQueue.begin(), mQueue.end(), later);
+
+			mQueue.pop_back();
+
+			// Find the exact time of a carried over event.
+			Object & O1 = mObjects[event.mObject];
+
+			if (!event.mExact && event.mWall) SphereQuadsBatch(O1.mSphere, O1.mMotion, mWallTable, &event.mOther, 1, &event.mT);
+
+			else if (!event.mExact)
+			{
+				Object & O2 = mObjects[event.mOther];
+
+				Hit hit(FLT_MAX);
+
+				event.mT = Spheres(O1.mSphere, O2.mSphere, O1.mMotion, O2.mMotion, hit) ? hit.mT : -1.0f;
+			}
+
+			event.mExact = true;
+
+			if (event.mT >= 0.0f && event.mT < fEarliest && (!event.mWall || mWallTable.mPlaneOnly[event.mOther])) fEarliest = event.mT;
+		}
+	}
+
+	/// @brief Updates the count of steps in which the objects made no progress
+	/// @note A step makes no progress if it has the same contacts as the previous one, and
+	///       these occur at once
+	void World::UpdateStuck (void)
+	{
+		bool bSame = !mContacts.empty() && mTime <= fSimultaneity && mContacts.size() == mPrevContacts.size();
+
+		for (Uint i = 0; bSame && i < mContacts.size(); ++i)
+		{
+			Contact & C = mContacts[i], & P = mPrevContacts[i];
+
+			bSame = C.mObject == P.mObject && C.mOther == P.mOther && C.mWall == P.mWall;
+		}
+
+		mStuckCount = bSame ? mStuckCount + 1 : 0;
+
+		mPrevContacts = mContacts;
+	}
+}
\ No newline at end of file
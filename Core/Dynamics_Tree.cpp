@@ -0,0 +1,197 @@
+#include "Dynamics.h"
+#include <algorithm>
+
+namespace Dynamics
+{
+	/// @brief Slack added to bounds, to cover the collision tolerances
+	static const float fSlack = 0.01f;
+
+	/// @brief Maximum count of boxes in a leaf
+	static const Uint LeafSize = 4;
+
+	/// @brief Orders box indices by center along an axis
+	struct CenterLess {
+		std::vector<Box> const & mBoxes;///< Boxes being ordered
+		Uint mAxis;	///< Axis of comparison
+
+		CenterLess (std::vector<Box> const & boxes, Uint axis) : mBoxes(boxes), mAxis(axis) {}
+
+		bool operator () (Uint i1, Uint i2) const
+		{
+			return mBoxes[i1].mMin.m[mAxis] + mBoxes[i1].mMax.m[mAxis] < mBoxes[i2].mMin.m[mAxis] + mBoxes[i2].mMax.m[mAxis];
+		}
+	};
+
+	/// @brief Constructs a Box object
+	/// @param quad Quad to bound
+	Box::Box (Quad const & quad) : mMin(quad.mCorners[0]), mMax(quad.mCorners[0])
+	{
+		for (int index = 1; index < 4; ++index)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				mMin.m[k] = std::min(mMin.m[k], quad.mCorners[index].m[k]);
+				mMax.m[k] = std::max(mMax.m[k], quad.mCorners[index].m[k]);
+			}
+		}
+
+		for (int k = 0; k < 3; ++k) mMin.m[k] -= fSlack, mMax.m[k] += fSlack;
+	}
+
+	/// @brief Constructs a Box object
+	/// @param sphere Sphere to bound
+	/// @param motion Sphere motion
+	/// @param fLimit Time limit of sweep
+	Box::Box (Sphere const & sphere, Vector const & motion, float fLimit)
+	{
+		float fR = sphere.mRadius + fSlack;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			float fC = sphere.mCenter.m[k], fV = motion.m[k] * fLimit;
+
+			mMin.m[k] = std::min(fC, fC + fV) - fR;
+			mMax.m[k] = std::max(fC, fC + fV) + fR;
+		}
+	}
+
+	/// @brief Indicates whether two boxes overlap
+	/// @param box Box to test
+	/// @return If true, the boxes overlap
+	bool Box::Overlaps (Box const & box) const
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			if (mMin.m[k] > box.mMax.m[k] || box.mMin.m[k] > mMax.m[k]) return false;
+		}
+
+		return true;
+	}
+
+	/// @brief Adds a box to the tree
+	/// @param box Box to add
+	/// @note The box is given the next index; the tree must be rebuilt to include it
+	void Tree::Add (Box const & box)
+	{
+		mBoxes.push_back(box);
+	}
+
+	/// @brief Builds the tree over the boxes added so far
+	void Tree::Build (void)
+	{
+		mNodes.clear();
+		mIndices.resize(mBoxes.size());
+
+		for (Uint i = 0; i < mIndices.size(); ++i) mIndices[i] = i;
+
+		if (!mBoxes.empty()) Split(0, Uint(mBoxes.size()));
+	}
+
+	/// @brief Clears the tree
+	void Tree::Clear (void)
+	{
+		mBoxes.clear();
+		mIndices.clear();
+		mNodes.clear();
+	}
+
+	/// @brief Finds the boxes that overlap a query box
+	/// @param box Query box
+	/// @param indices [out] Indices of overlapping boxes, in no particular order
+	void Tree::Query (Box const & box, std::vector<Uint> & indices) const
+	{
+		indices.clear();
+
+		if (mNodes.empty()) return;
+
+		// Walk the tree, descending into overlapped branches. Leftmost children are visited
+		// immediately; right children wait on the stack.
+		Uint stack[64], top = 0, node = 0;
+
+		for (;;)
+		{
+			Node const & N = mNodes[node];
+
+			if (N.mBox.Overlaps(box))
+			{
+				if (0 == N.mCount)
+				{
+					stack[top++] = N.mFirst;
+
+					++node;
+
+					continue;
+				}
+
+				for (Uint i = N.mFirst; i < N.mFirst + N.mCount; ++i)
+				{
+					if (mBoxes[mIndices[i]].Overlaps(box)) indices.push_back(mIndices[i]);
+				}
+			}
+
+			if (0 == top) break;
+
+			node = stack[--top];
+		}
+	}
+
+	/// @brief Gets the count of boxes in the tree
+	/// @return Box count
+	Uint Tree::GetCount (void) const
+	{
+		return Uint(mBoxes.size());
+	}
+
+	/// @brief Builds a subtree over a range of the index list
+	/// @param first Index of first entry in range
+	/// @param count Count of entries in range
+	void Tree::Split (Uint first, Uint count)
+	{
+		Uint node = Uint(mNodes.size());
+
+		mNodes.push_back(Node());
+
+		// Bound the range.
+		Box bounds = mBoxes[mIndices[first]];
+
+		for (Uint i = first + 1; i < first + count; ++i)
+		{
+			Box const & box = mBoxes[mIndices[i]];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				bounds.mMin.m[k] = std::min(bounds.mMin.m[k], box.mMin.m[k]);
+				bounds.mMax.m[k] = std::max(bounds.mMax.m[k], box.mMax.m[k]);
+			}
+		}
+
+		mNodes[node].mBox = bounds;
+
+		// Small ranges become leaves.
+		if (count <= LeafSize)
+		{
+			mNodes[node].mFirst = first;
+			mNodes[node].mCount = count;
+
+			return;
+		}
+
+		// Split the range about its median along the longest axis. The left child follows
+		// this node; the right child follows the left subtree.
+		Uint axis = 0, half = count / 2;
+
+		for (Uint k = 1; k < 3; ++k)
+		{
+			if (bounds.mMax.m[k] - bounds.mMin.m[k] > bounds.mMax.m[axis] - bounds.mMin.m[axis]) axis = k;
+		}
+
+		std::nth_element(mIndices.begin() + first, mIndices.begin() + first + half, mIndices.begin() + first + count, CenterLess(mBoxes, axis));
+
+		Split(first, half);
+
+		mNodes[node].mFirst = Uint(mNodes.size());
+		mNodes[node].mCount = 0;
+
+		Split(first + half, count - half);
+	}
+}
\ No newline at end of file
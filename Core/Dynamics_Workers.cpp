@@ -0,0 +1,175 @@
+#include "Dynamics.h"
+#include <SDL/SDL_mutex.h>
+#include <SDL/SDL_thread.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace Dynamics
+{
+	/// @brief Pool shared by all worlds, if any are using it
+	static Workers * spShared;
+
+	/// @brief Constructs a Workers object
+	/// @note No threads are started until some are reserved
+	Workers::Workers (void) : mDone(SDL_CreateSemaphore(0)), mJob(0), mData(0), mUsers(0), mQuit(false)
+	{
+	}
+
+	/// @brief Destructs a Workers object
+	Workers::~Workers (void)
+	{
+		SetCount(0);
+
+		SDL_DestroySemaphore(mDone);
+	}
+
+	/// @brief Acquires the shared pool, creating it if no world is using it
+	/// @return Shared pool
+	Workers & Workers::Acquire (void)
+	{
+		if (0 == spShared) spShared = new Workers;
+
+		++spShared->mUsers;
+
+		return *spShared;
+	}
+
+	/// @brief Releases the shared pool, stopping its threads once no world is using it
+	void Workers::Release (void)
+	{
+		if (--spShared->mUsers > 0) return;
+
+		delete spShared;
+
+		spShared = 0;
+	}
+
+	/// @brief Ensures the pool has at least a given count of threads
+	/// @param count Count of threads wanted alongside the calling thread
+	/// @note Threads are kept until the pool is released, so worlds wanting fewer share them
+	void Workers::Reserve (Uint count)
+	{
+		if (count > mThreads.size()) SetCount(count);
+	}
+
+	/// @brief Runs a job over several lanes
+	/// @param job Job to run, given the job data and a lane index
+	/// @param pData Job data
+	/// @param count Count of lanes, at most one more than the worker count
+	/// @note Lane 0 is run on the calling thread; this returns once all lanes are done
+	void Workers::Run (void (*job)(void *, Uint), void * pData, Uint count)
+	{
+		if (count > mThreads.size() + 1) count = Uint(mThreads.size()) + 1;
+
+		mJob = job;
+		mData = pData;
+
+		// Hand the remaining lanes to workers, run the first one here, then wait for the
+		// workers to finish. The semaphores order the job and its results between threads.
+		for (Uint i = 1; i < count; ++i)
+		{
+			mThreads[i - 1]->mLane = i;
+
+			SDL_SemPost(mThreads[i - 1]->mStart);
+		}
+
+		if (count > 0) job(pData, 0);
+
+		for (Uint i = 1; i < count; ++i) SDL_SemWait(mDone);
+	}
+
+	/// @brief Sets the count of worker threads
+	/// @param count Count of threads to run alongside the calling thread
+	/// @note If a thread cannot be started, the count stops short
+	void Workers::SetCount (Uint count)
+	{
+		// Stop surplus threads. Shutdown is signaled through the start semaphore.
+		while (mThreads.size() > count)
+		{
+			Thread * pThread = mThreads.back();
+
+			mQuit = true;
+
+			SDL_SemPost(pThread->mStart);
+			SDL_WaitThread(pThread->mThread, 0);
+			SDL_DestroySemaphore(pThread->mStart);
+
+			delete pThread;
+
+			mThreads.pop_back();
+		}
+
+		mQuit = false;
+
+		// Start any new threads.
+		while (mThreads.size() < count)
+		{
+			Thread * pThread = new Thread;
+
+			pThread->mOwner = this;
+			pThread->mStart = SDL_CreateSemaphore(0);
+			pThread->mLane = 0;
+			pThread->mThread = SDL_CreateThread(Main, pThread);
+
+			if (0 == pThread->mThread)
+			{
+				SDL_DestroySemaphore(pThread->mStart);
+
+				delete pThread;
+
+				break;
+			}
+
+			mThreads.push_back(pThread);
+		}
+	}
+
+	/// @brief Gets the count of worker threads
+	/// @return Thread count
+	Uint Workers::GetCount (void) const
+	{
+		return Uint(mThreads.size());
+	}
+
+	/// @brief Body of a worker thread
+	/// @param pThread Thread state
+	/// @return 0
+	int Workers::Main (void * pThread)
+	{
+		Thread * pT = static_cast<Thread*>(pThread);
+
+		for (;;)
+		{
+			SDL_SemWait(pT->mStart);
+
+			if (pT->mOwner->mQuit) break;
+
+			pT->mOwner->mJob(pT->mOwner->mData, pT->mLane);
+
+			SDL_SemPost(pT->mOwner->mDone);
+		}
+
+		return 0;
+	}
+
+	/// @brief Gets the count of processors available to the program
+	/// @return Processor count, at least 1
+	Uint GetProcessorCount (void)
+	{
+	#ifdef _WIN32
+		SYSTEM_INFO info;
+
+		GetSystemInfo(&info);
+
+		long count = long(info.dwNumberOfProcessors);
+	#else
+		long count = sysconf(_SC_NPROCESSORS_ONLN);
+	#endif
+
+		return count > 0 ? Uint(count) : 1;
+	}
+}
\ No newline at end of file
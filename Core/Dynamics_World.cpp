@@ -0,0 +1,406 @@
+#include "Dynamics.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace Dynamics
+{
+	/// @brief Indicates whether two walls are identical
+	/// @param w1 First wall
+	/// @param w2 Second wall
+	/// @return If true, the walls are identical
+	static bool Same (Wall const & w1, Wall const & w2)
+	{
+		if (w1.mType != w2.mType || w1.mQuad.mETest != w2.mQuad.mETest || w1.mQuad.mVTest != w2.mQuad.mVTest) return false;
+
+		return memcmp(w1.mQuad.mCorners, w2.mQuad.mCorners, sizeof(w1.mQuad.mCorners)) == 0 && memcmp(w1.mQuad.mNormal.m, w2.mQuad.mNormal.m, sizeof(w1.mQuad.mNormal.m)) == 0;
+	}
+
+	/// @brief Constructs a World object
+	World::World (void) : mWorkers(Workers::Acquire()), mLog(0), mAxis(0), mTypeCount(0), mStuckCount(0), mWallRevision(0), mMaterialRevision(0), mWorkerCount(0), mLimit(0.0f), mTime(0.0f), mPrevTime(0.0f), mDeterministic(false), mLogWalls(false), mTreeDirty(false), mWallsChanged(false)
+	{
+	}
+
+	/// @brief Destructs a World object
+	World::~World (void)
+	{
+		StopLog();
+
+		Workers::Release();
+	}
+
+	/// @brief Adds an object
+	/// @param sphere Object bounding sphere
+	/// @param motion Object motion
+	/// @param type Object material type
+	/// @param revision Course revision, changed whenever the object departs from its motion
+	/// @note With a revision of 0, the object is tested afresh each step
+	void World::AddObject (Sphere const & sphere, Vector const & motion, Uint type, Uint revision)
+	{
+		Object object;
+
+		object.mSphere = sphere;
+		object.mMotion = motion;
+		object.mType = type;
+		object.mRevision = revision;
+
+		mObjects.push_back(object);
+	}
+
+	/// @brief Adds a wall
+	/// @param quad Wall quad
+	/// @param type Wall material type
+	void World::AddWall (Quad const & quad, Uint type)
+	{
+		mWalls.push_back(Wall(quad, type));
+
+		mTreeDirty = true;
+	}
+
+	/// @brief Clears all materials
+	void World::ClearMaterials (void)
+	{
+		mMaterials.assign(mMaterials.size(), 0);
+		mWallMaterials.assign(mWallMaterials.size(), 0);
+
+		++mMaterialRevision;
+	}
+
+	/// @brief Clears all objects
+	void World::ClearObjects (void)
+	{
+		mObjects.clear();
+	}
+
+	/// @brief Clears all walls
+	void World::ClearWalls (void)
+	{
+		mWalls.clear();
+
+		mTreeDirty = true;
+	}
+
+	/// @brief Sets whether hits are found deterministically
+	/// @param bDeterministic If true, floating-point behavior is pinned while finding hits
+	void World::SetDeterministic (bool bDeterministic)
+	{
+		mDeterministic = bDeterministic;
+	}
+
+	/// @brief Enables tests between a pair of types
+	/// @param type1 Type of first object
+	/// @param type2 Type of second object or wall
+	/// @param bWall If true, the second type is a wall type
+	void World::SetMaterial (Uint type1, Uint type2, bool bWall)
+	{
+		Reserve(type1 > type2 ? type1 : type2);
+
+		(bWall ? mWallMaterials : mMaterials)[type1 * mTypeCount + type2] = 1;
+
+		++mMaterialRevision;
+	}
+
+	/// @brief Sets the count of threads used to load events, besides the calling thread
+	/// @param count Thread count
+	/// @note The threads come from the shared pool, which grows as needed
+	void World::SetWorkerCount (Uint count)
+	{
+		mWorkers.Reserve(count);
+
+		mWorkerCount = count;
+	}
+
+	/// @brief Gets one of the earliest contacts
+	/// @param index Contact index
+	/// @return Contact
+	Contact const & World::GetContact (Uint index)
+	{
+		assert(index < mContacts.size());
+
+		return mContacts[index];
+	}
+
+	/// @brief Finds the earliest set of simultaneous hits over a time step
+	/// @param step Time step
+	/// @return Time of earliest hits, or step if none occurred
+	/// @note Hits within the simultaneity window of the earliest hit are all kept
+	float World::FindHits (float step)
+	{
+		FPState state(mDeterministic);
+
+		mContacts.clear();
+
+		mTime = step;
+
+		FindPairs(step + fSimultaneity);
+
+		// Rebuild the wall hierarchy and table if the walls have changed.
+		UpdateWalls();
+
+		// Predict the contacts, carrying over those of objects that have kept to their course
+		// since the last step, and resolve the earliest ones.
+		mLimit = step + fSimultaneity;
+
+		MarkTouched();
+		LoadEvents();
+		ResolveEvents(mLimit);
+
+		// Events are visited in test order, as the simultaneity test depends on the order in
+		// which hits arrive. Any hit under the current limit is then resolved by the full test.
+		for (Uint i = 0; i < mEvents.size(); ++i)
+		{
+			Event & event = mEvents[i];
+
+			if (!event.mExact || event.mT < 0.0f || event.mT >= mTime + fSimultaneity) continue;
+
+			Object & O1 = mObjects[event.mObject];
+
+			Hit hit(mTime + fSimultaneity);
+
+			bool bHit;
+
+			if (event.mWall) bHit = SphereQuad(O1.mSphere, mWalls[event.mOther].mQuad, O1.mMotion, hit);
+
+			else bHit = Spheres(O1.mSphere, mObjects[event.mOther].mSphere, O1.mMotion, mObjects[event.mOther].mMotion, hit);
+
+			if (bHit) AddContact(event.mObject, event.mOther, event.mWall, hit);
+		}
+
+		// Record the step, if logging. Keep this step's state, to predict the next one.
+		if (mLog) LogStep(step);
+
+		UpdateStuck();
+
+		mPrevEvents.swap(mEvents);
+
+		mPrevObjects = mObjects;
+		mPrevTime = mTime;
+
+		mWallsChanged = false;
+
+		return mTime;
+	}
+
+	/// @brief Gets the count of earliest contacts
+	/// @return Contact count
+	Uint World::GetContactCount (void)
+	{
+		return Uint(mContacts.size());
+	}
+
+	/// @brief Gets the count of objects
+	/// @return Object count
+	Uint World::GetObjectCount (void)
+	{
+		return Uint(mObjects.size());
+	}
+
+	/// @brief Gets the count of walls
+	/// @return Wall count
+	Uint World::GetWallCount (void)
+	{
+		return Uint(mWalls.size());
+	}
+
+	/// @brief Gets the count of threads used to load events, besides the calling thread
+	/// @return Thread count
+	Uint World::GetWorkerCount (void)
+	{
+		return std::min(mWorkerCount, mWorkers.GetCount());
+	}
+
+	/// @brief Indicates whether hits are found deterministically
+	/// @return If true, floating-point behavior is pinned while finding hits
+	bool World::IsDeterministic (void)
+	{
+		return mDeterministic;
+	}
+
+	/// @brief Indicates whether the objects appear to be stuck
+	/// @return If true, the objects have made no progress over several steps
+	bool World::IsStuck (void)
+	{
+		return mStuckCount >= StuckSteps;
+	}
+
+	/// @brief Indicates whether a pair of types is to be tested
+	/// @param materials Material table
+	/// @param type1 Type of first object
+	/// @param type2 Type of second object or wall
+	/// @return If true, the pair is tested
+	bool World::Tests (std::vector<Uint8> const & materials, Uint type1, Uint type2)
+	{
+		if (type1 >= mTypeCount || type2 >= mTypeCount) return false;
+
+		return materials[type1 * mTypeCount + type2] != 0;
+	}
+
+	/// @brief Adds a contact to the earliest set
+	/// @param object Index of object
+	/// @param other Index of other object or wall
+	/// @param bWall If true, the other index refers to a wall
+	/// @param hit Hit information
+	void World::AddContact (Uint object, Uint other, bool bWall, Hit const & hit)
+	{
+		// If the time is not simultaneous with earlier hits, empty the set of concurrent
+		// hits and update the minimum time. Add the hit to the set.
+		if (fabsf(hit.mT - mTime) > fSimultaneity)
+		{
+			mContacts.clear();
+
+			mTime = hit.mT;
+		}
+
+		Contact contact;
+
+		contact.mObject = object;
+		contact.mOther = other;
+		contact.mWall = bWall;
+		contact.mPoint = hit.mContact;
+		contact.mNormal = hit.mNormal;
+
+		mContacts.push_back(contact);
+	}
+
+	/// @brief Finds the object pairs whose swept extents overlap
+	/// @param fLimit Time limit of sweeps
+	/// @note The sort order is kept between calls, so that the insertion sort is cheap when
+	///       objects are reloaded in the same order over successive steps
+	void World::FindPairs (float fLimit)
+	{
+		mPairs.clear();
+
+		// If the object set has changed size, restart the order, sorting along the axis on
+		// which the objects are most spread out.
+		Uint count = Uint(mObjects.size());
+
+		if (mOrder.size() != count)
+		{
+			mOrder.resize(count);
+
+			Vector lo, hi;
+
+			for (Uint i = 0; i < count; ++i)
+			{
+				Vector const & C = mObjects[i].mSphere.mCenter;
+
+				mOrder[i] = i;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					if (0 == i || C.m[k] < lo.m[k]) lo.m[k] = C.m[k];
+					if (0 == i || C.m[k] > hi.m[k]) hi.m[k] = C.m[k];
+				}
+			}
+
+			Vector spread = hi - lo;
+
+			mAxis = 0;
+
+			for (Uint k = 1; k < 3; ++k) if (spread.m[k] > spread.m[mAxis]) mAxis = k;
+		}
+
+		// Sweep each object along the axis over the time limit.
+		mExtents.resize(count);
+
+		for (Uint i = 0; i < count; ++i)
+		{
+			Object & O = mObjects[i];
+
+			float fC = O.mSphere.mCenter.m[mAxis], fV = O.mMotion.m[mAxis] * fLimit;
+			float fR = O.mSphere.mRadius + fSimultaneity;
+
+			mExtents[i].mMin = std::min(fC, fC + fV) - fR;
+			mExtents[i].mMax = std::max(fC, fC + fV) + fR;
+		}
+
+		// Insertion sort the order by lower bound; this is near linear when little has moved.
+		for (Uint i = 1; i < count; ++i)
+		{
+			Uint index = mOrder[i], j = i;
+
+			for (; j > 0 && mExtents[mOrder[j - 1]].mMin > mExtents[index].mMin; --j) mOrder[j] = mOrder[j - 1];
+
+			mOrder[j] = index;
+		}
+
+		// Sweep through the order, pairing each object with those still open.
+		for (Uint i = 0; i < count; ++i)
+		{
+			Uint index = mOrder[i];
+
+			for (Uint j = i + 1; j < count && mExtents[mOrder[j]].mMin <= mExtents[index].mMax; ++j)
+			{
+				mPairs.push_back(std::make_pair(index, mOrder[j]));
+				mPairs.push_back(std::make_pair(mOrder[j], index));
+			}
+		}
+
+		std::sort(mPairs.begin(), mPairs.end());
+	}
+
+	/// @brief Grows the material tables to cover a type
+	/// @param type Type to cover
+	void World::Reserve (Uint type)
+	{
+		if (type < mTypeCount) return;
+
+		// Copy the old tables into the larger ones.
+		Uint count = type + 1;
+
+		std::vector<Uint8> materials(count * count, 0), wallMaterials(count * count, 0);
+
+		for (Uint type1 = 0; type1 < mTypeCount; ++type1)
+		{
+			for (Uint type2 = 0; type2 < mTypeCount; ++type2)
+			{
+				materials[type1 * count + type2] = mMaterials[type1 * mTypeCount + type2];
+				wallMaterials[type1 * count + type2] = mWallMaterials[type1 * mTypeCount + type2];
+			}
+		}
+
+		mMaterials.swap(materials);
+		mWallMaterials.swap(wallMaterials);
+
+		mTypeCount = count;
+	}
+
+	/// @brief Rebuilds the wall hierarchy and table if the walls have changed
+	/// @note The change is noted for the next step, which may not be the next caller; the
+	///       walls that differ from those of the last rebuild are also noted, for paths
+	void World::UpdateWalls (void)
+	{
+		if (!mTreeDirty) return;
+
+		mTree.Clear();
+
+		mWallTable.Clear();
+
+		mChangedBoxes.clear();
+
+		for (Uint i = 0; i < mWalls.size(); ++i)
+		{
+			mTree.Add(Box(mWalls[i].mQuad));
+			mWallTable.Add(mWalls[i].mQuad);
+
+			if (i < mBuiltWalls.size() && Same(mWalls[i], mBuiltWalls[i])) continue;
+
+			mChangedBoxes.push_back(Box(mWalls[i].mQuad));
+
+			if (i < mBuiltWalls.size()) mChangedBoxes.push_back(Box(mBuiltWalls[i].mQuad));
+		}
+
+		for (Uint i = Uint(mWalls.size()); i < mBuiltWalls.size(); ++i) mChangedBoxes.push_back(Box(mBuiltWalls[i].mQuad));
+
+		mTree.Build();
+
+		mBuiltWalls = mWalls;
+
+		mTreeDirty = false;
+		mWallsChanged = true;
+		mLogWalls = true;
+
+		++mWallRevision;
+	}
+}
\ No newline at end of file
@@ -103,7 +103,15 @@ namespace Lua
 		luaL_checktype(L, index, LUA_TUSERDATA);
 
 		lua_getmetatable(L, index);	// ..., ud, ..., mt
-		lua_getfield(L, -1, "size");// ..., ud, ..., mt, size
+
+		// User types keep their size in the first array slot; otherwise, look it up by name.
+		lua_rawgeti(L, -1, 1);	// ..., ud, ..., mt, size
+
+		if (lua_isnil(L, -1))
+		{
+			lua_pop(L, 1);	// ..., ud, ..., mt
+			lua_getfield(L, -1, "size");// ..., ud, ..., mt, size
+		}
 
 		int size = I(L, -1);
 
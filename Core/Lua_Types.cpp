@@ -2,25 +2,145 @@
 #include <cassert>
 #include <cctype>
 #include <cstdarg>
+#include <map>
+#include <vector>
 
 namespace Lua
 {
-	/// @brief Gets the metatable fields
-	static Uint8 * GetMetaFields (lua_State * L)
+	/// @brief Slot in each user type metatable holding the instance size
+	/// @note This is an array slot, so that it is read without hashing a key
+	static const int SizeSlot = 1;
+
+	/// @brief Compiled user type member
+	struct UserField {
+		char const * mKey;	///< Interned member name, or 0 if the slot is empty
+		struct UserType * mUserType;///< Member type, for user type members, once resolved
+		char const * mUserTypeName;	///< Member type name, for user type members
+		size_t mOffset;	///< Offset of member in datum
+		int mType;	///< Member type
+	};
+
+	/// @brief Compiled user type
+	struct UserType {
+		std::vector<UserField> mFields;	///< Members, perfectly hashed by interned name
+		std::string mName;	///< Type name
+		size_t mSize;	///< Datum size, or 0 if passed by reference
+		Uint32 mMultiplier;	///< Hash multiplier
+		Uint mShift;///< Hash shift
+		int mRef;	///< Registry reference to metatable
+
+		/// @brief Hashes a member name
+		/// @param key Interned member name
+		/// @return Slot in the member table
+		Uint Slot (char const * key) const
+		{
+			size_t bits = size_t(key);
+
+			return Uint((Uint32(bits) ^ Uint32(bits >> 16 >> 16)) * mMultiplier >> mShift);
+		}
+
+		/// @brief Finds a member
+		/// @param key Interned member name
+		/// @return Member, or 0 if the type has no such member
+		UserField * Find (char const * key)
+		{
+			UserField & field = mFields[Slot(key)];
+
+			return field.mKey == key ? &field : 0;
+		}
+	};
+
+	/// @brief Compiled user types, by name; these live as long as the program
+	static std::map<std::string, UserType *> sUserTypes;
+
+	/// @brief Looks up a compiled user type
+	/// @param name Type name
+	/// @return User type, or 0 if none is registered under the name
+	/// @note Names are compared by text, since callers may pass temporary buffers
+	static UserType * FindUserType (char const * name)
+	{
+		std::map<std::string, UserType *>::iterator iter = sUserTypes.find(name);
+
+		return iter != sUserTypes.end() ? iter->second : 0;
+	}
+
+	/// @brief Lays out a user type's members in a table of a given size
+	/// @param pType Compiled user type
+	/// @param reg Type bindings
+	/// @param keys Interned member names
+	/// @param count Count of bindings
+	/// @param bits Table size, as a power of 2
+	/// @return If true, a multiplier was found under which no two members share a slot
+	static bool Compile (UserType * pType, UserType_Reg const * reg, char const * const * keys, Uint count, Uint bits)
+	{
+		pType->mShift = 32 - bits;
+
+		for (Uint32 attempt = 0; attempt < 64; ++attempt)
+		{
+			pType->mFields.assign(size_t(1) << bits, UserField());
+			pType->mMultiplier = 2654435761U + 2 * attempt;
+
+			Uint index = 0;
+
+			for (; index < count; ++index)
+			{
+				UserField & field = pType->mFields[pType->Slot(keys[index])];
+
+				if (field.mKey != 0) break;
+
+				field.mKey = keys[index];
+				field.mUserType = 0;
+				field.mUserTypeName = reg[index].mUserType;
+				field.mOffset = reg[index].mOffset;
+				field.mType = reg[index].mType;
+			}
+
+			if (index == count) return true;
+		}
+
+		return false;
+	}
+
+	/// @brief Pushes a user type onto the stack
+	/// @param L Lua state
+	/// @param data User type data
+	/// @param pType Compiled user type, as returned by GetUserType
+	void PushUserType (lua_State * L, void * data, UserType * pType)
+	{
+		// If the size is 0, pass the data by reference. Otherwise, copy it into the buffer.
+		size_t size = pType->mSize;
+
+		void * udata = lua_newuserdata(L, size != 0 ? size : sizeof(void*));	// u
+
+		memcpy(udata, size != 0 ? data : &data, size != 0 ? size : sizeof(void*));
+
+		// Bind the userdata to its type's metatable.
+		lua_rawgeti(L, LUA_REGISTRYINDEX, pType->mRef);	// u mt
+		lua_setmetatable(L, -2);// u
+	}
+
+	/// @brief Gets the member being accessed
+	/// @param L Lua state
+	/// @param index Stack index of userdata; the key follows it
+	/// @param pData [out] Datum address
+	/// @return Member
+	/// @note The compiled user type is upvalue 1
+	static UserField & GetField (lua_State * L, int index, Uint8 *& pData)
 	{
-		Uint8 * pData = static_cast<Uint8*>(UT(L, -2));	// ..., u, k
-
-		lua_getmetatable(L, -2);// ..., u, k, mt
-		lua_insert(L, -2);	// ..., u, mt, k
-		lua_gettable(L, -2);// ..., u, mt, dt
-		lua_getfield(L, -1, "usertype");// ..., u, mt, dt, ut
-		lua_getfield(L, -2, "offset");	// ..., u, mt, dt, ut, o
-		lua_getfield(L, -3, "type");// ..., u, mt, dt, ut, o, t
-		lua_insert(L, -6);	// ..., t, u, mt, dt, ut, o
-		lua_insert(L, -6);	// ..., o, t, u, mt, dt, ut
-		lua_insert(L, -6);	// ..., ut, o, t, u, mt, dt
-
-		return pData;
+		UserType * pType = static_cast<UserType*>(lua_touserdata(L, lua_upvalueindex(1)));
+
+		pData = static_cast<Uint8*>(lua_touserdata(L, index));
+
+		if (0 == pType->mSize) pData = *(Uint8**)pData;
+
+		// Keys are interned, so compare them by address.
+		UserField * pField = lua_type(L, index + 1) == LUA_TSTRING ? pType->Find(lua_tostring(L, index + 1)) : 0;
+
+		if (0 == pField) luaL_error(L, "%s has no member %s", pType->mName.c_str(), lua_isstring(L, index + 1) ? lua_tostring(L, index + 1) : luaL_typename(L, index + 1));
+
+		pData += pField->mOffset;
+
+		return *pField;
 	}
 
 	#define N_(t, p) lua_pushnumber(L, *(t*)p)
@@ -29,15 +149,19 @@ namespace Lua
 	static int Index (lua_State * L)
 	{
 		// Point to the requested member.
-		Uint8 * pData = GetMetaFields(L);	// ut, o, t
+		Uint8 * pData;
 
-		pData += U(L, 2);
+		UserField & field = GetField(L, 1, pData);
 
 		// Return the appropriate type.
-		switch (U(L, 3))
+		switch (field.mType)
 		{
 		case UserType_Reg::eUserType:
-			PushUserType(L, pData, S(L, 1));
+			if (0 == field.mUserType) field.mUserType = FindUserType(field.mUserTypeName);
+
+			if (0 == field.mUserType) luaL_error(L, "Unregistered user type %s", field.mUserTypeName);
+
+			PushUserType(L, pData, field.mUserType);
 			break;
 		case UserType_Reg::ePointer:
 			lua_pushlightuserdata(L, *(void**)pData);
@@ -104,38 +228,36 @@ namespace Lua
 	static int NewIndex (lua_State * L)
 	{
 		// Point to the requested member.
-		lua_insert(L, 1);	// v, u, k
-
-		Uint8 * pData = GetMetaFields(L);	// v, ut, o, t
+		Uint8 * pData;
 
-		pData += U(L, 3);
+		UserField & field = GetField(L, 1, pData);
 
 		// Assign the appropriate type.
-		switch (U(L, 4))
+		switch (field.mType)
 		{
 		case UserType_Reg::eUserType:
 			break;
 		case UserType_Reg::ePointer:
-			*(void**)pData = UD(L, 1);
+			*(void**)pData = UD(L, 3);
 			break;
 		case UserType_Reg::eU8:
-			*(Uint8*)pData = U8(L, 1);
+			*(Uint8*)pData = U8(L, 3);
 			break;
 		case UserType_Reg::eS8:
 			break;
 		case UserType_Reg::eU16:
 		case UserType_Reg::eUShort:
-			*(Uint16*)pData = U16(L, 1);
+			*(Uint16*)pData = U16(L, 3);
 			break;
 		case UserType_Reg::eS16:
 		case UserType_Reg::eSShort:
-			*(Sint16*)pData = S16(L, 1);
+			*(Sint16*)pData = S16(L, 3);
 			break;
 		case UserType_Reg::eU32:
-			*(Uint32*)pData = U(L, 1);
+			*(Uint32*)pData = U(L, 3);
 			break;
 		case UserType_Reg::eS32:
-			*(Sint32*)pData = S32(L, 1);
+			*(Sint32*)pData = S32(L, 3);
 			break;
 		case UserType_Reg::eUChar:
 			break;
@@ -144,19 +266,19 @@ namespace Lua
 		case UserType_Reg::eULong:
 			break;
 		case UserType_Reg::eSLong:
-			*(long*)pData = LI(L, 1);
+			*(long*)pData = LI(L, 3);
 			break;
 		case UserType_Reg::eUInt:
 			break;
 		case UserType_Reg::eSInt:
 			break;
 		case UserType_Reg::eFloat:
-			*(float*)pData = F(L, 1);
+			*(float*)pData = F(L, 3);
 			break;
 		case UserType_Reg::eString:
 			break;
 		case UserType_Reg::eBoolean:
-			*(bool*)pData = B(L, 1);
+			*(bool*)pData = B(L, 3);
 			break;
 		}
 
@@ -304,8 +426,6 @@ namespace Lua
 		lua_pushcfunction(L, newf);	// ..., newf
 
 		class_Define(L, name, methods, closures, count, base, size);
-
-		lua_pop(L, 1);
 	}
 
 	/// @brief Defines a class, with closures on the stack and new function at the top
@@ -403,28 +523,27 @@ namespace Lua
 		lua_call(L, count + 1, 0);
 	}
 
-	/// @brief Pushes a user type onto the stack
+	/// @brief Gets a registered user type
 	/// @param L Lua state
-	/// @param data User type data
 	/// @param name Type name
-	void PushUserType (lua_State * L, void * data, char const * name)
+	/// @return User type, which stays valid even if the type is registered again
+	/// @note Hot callers keep the result, to push without looking up the name
+	UserType * GetUserType (lua_State * L, char const * name)
 	{
-		// Get the metatable and acquire the instance size.
-		lua_getfield(L, LUA_REGISTRYINDEX, name);	// mt
-		lua_getfield(L, -1, "size");// mt size
+		UserType * pType = FindUserType(name);
 
-		// If the size is 0, pass the data by reference. Otherwise, copy it into the buffer.
-		int size = I(L, -1);
-
-		lua_pop(L, 1);	// mt
-
-		void * udata = lua_newuserdata(L, size != 0 ? size : sizeof(void*));// mt u
+		if (0 == pType) luaL_error(L, "Unregistered user type %s", name);
 
-		memcpy(udata, size != 0 ? data : &data, size != 0 ? size : sizeof(void*));
+		return pType;
+	}
 
-		// Bind the userdata to its type's metatable.
-		lua_insert(L, -2);	// u mt
-		lua_setmetatable(L, -2);// u
+	/// @brief Pushes a user type onto the stack
+	/// @param L Lua state
+	/// @param data User type data
+	/// @param name Type name
+	void PushUserType (lua_State * L, void * data, char const * name)
+	{
+		PushUserType(L, data, GetUserType(L, name));
 	}
 
 	/// @brief Registers a user type with Lua
@@ -437,15 +556,33 @@ namespace Lua
 	/// @note Vararg parameters are metamethod functions
 	void RegisterUserType (lua_State * L, char const * name, UserType_Reg * reg, Uint count, size_t size, char * format, ...)
 	{
-		// Install the usertype metatable and install variable metamethods.
+		// Compile the type, or recompile it if it was already registered.
+		UserType *& pType = sUserTypes[name];
+
+		if (0 == pType) pType = new UserType;
+
+		else luaL_unref(L, LUA_REGISTRYINDEX, pType->mRef);
+
+		pType->mName = name;
+		pType->mSize = size;
+
+		// Install the usertype metatable and install variable metamethods. These access the
+		// compiled type directly.
 		luaL_newmetatable(L, name);	// {}
 
-		L_(cfunction, "__index", Index);// { __index = Index }
-		L_(cfunction, "__newindex", NewIndex);// { __index, __newindex = NewIndex }
+		lua_pushlightuserdata(L, pType);// {}, ut
+		lua_pushcclosure(L, Index, 1);	// {}, Index
+		lua_setfield(L, -2, "__index");	// { __index = Index }
+		lua_pushlightuserdata(L, pType);// { __index }, ut
+		lua_pushcclosure(L, NewIndex, 1);	// { __index }, NewIndex
+		lua_setfield(L, -2, "__newindex");	// { __index, __newindex = NewIndex }
 
 		// Store the instance size.
 		L_(number, "size", size);	// { __index, __newindex, size }
 
+		lua_pushinteger(L, int(size));	// { __index, __newindex, size }, size
+		lua_rawseti(L, -2, SizeSlot);	// { __index, __newindex, size, [SizeSlot] = size }
+
 		// Add metamethods.
 		va_list function;	va_start(function, format);
 
@@ -458,18 +595,36 @@ namespace Lua
 	   
 		va_end(function);
 
-		// Register variable addresses.
+		// Intern the member names, keeping them in the metatable so that their addresses
+		// stay valid.
+		std::vector<char const *> keys(count + 1);
+
+		lua_createtable(L, int(count), 0);	// { __index, __newindex, size, [...] }, {}
+
 		for (Uint index = 0; index < count; ++index)
 		{
-			lua_newtable(L);// { __index, __newindex, size, [...] }, {}
+			lua_pushstring(L, reg[index].mName);// { __index, __newindex, size, [...] }, { ... }, n
 
-			L_(string, "usertype", reg[index].mUserType);	// { __index, __newindex, size, [...] }, { usertype = ut }
-			L_(number, "offset", reg[index].mOffset);	// { __index, __newindex, size, [...] }, { usertype, offset = o }
-			L_(number, "type", reg[index].mType);	// { __index, __newindex, size, [...] }, { usertype, offset, type = t }
+			keys[index] = lua_tostring(L, -1);
 
-			lua_setfield(L, -2, reg[index].mName);	// { __index, __newindex, size, [...], n = { usertype, offset, type } }
+			lua_rawseti(L, -2, int(index) + 1);	// { __index, __newindex, size, [...] }, { ..., n }
 		}
 
+		lua_setfield(L, -2, "members");	// { __index, __newindex, size, [...], members }
+
+		// Find a table size and multiplier under which no two members share a slot. The
+		// table is grown until one is found, which is quick for a handful of names.
+		Uint bits = 1;
+
+		while ((Uint(1) << bits) < count) ++bits;
+
+		while (!Compile(pType, reg, &keys[0], count, bits)) ++bits;
+
+		// Keep the metatable by reference.
+		lua_pushvalue(L, -1);	// mt, mt
+
+		pType->mRef = luaL_ref(L, LUA_REGISTRYINDEX);	// mt
+
 		// Restore stack.
 		lua_pop(L, 1);
 	}
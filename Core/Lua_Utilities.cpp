@@ -3,295 +3,299 @@
 
 namespace Lua
 {
-	/// @brief Data indices
+	/// @brief Upvalue indices of the __index and __newindex closures
 	enum {
-		eDescriptors = 1,	///< Descriptor table index
-		eNoRead,///< Non-read permission table index
-		eNoWrite,	///< Non-write permission table index
-		eLookup	///< Lookup means index
+		eAccessors = 1,	///< Getter or setter table index
+		eLType,	///< Lookup type index
+		eLKey,	///< Lookup key index
+		ePropagate	///< Propagation boolean index
 	};
 
-	/// @brief Descriptor indices
-	enum {
-		eDOffset = 1,	///< Offset index
-		eDName,	///< Name index
-		eDType	///< Type index
-	};
-
-	/// @brief Lookup indices
-	enum {
-		eLType = 1,	///< Lookup type index
-		eLKey	///< Key index
-	};
+	/// @brief Bits of a member entry used for its type; the rest hold the member offset
+	const int TypeBits = 5;
 
-	/// @brief Gets member fields
-	/// @note upvalue 1: Member descriptor, non-permissions, and lookup data
-	static Uint8 * GetFields (lua_State * L)
+	/// @brief Reads a member
+	/// @param pData Member data
+	/// @param entry Member entry
+	/// @note Pushes the member value
+	static void GetMember (lua_State * L, Uint8 * pData, lua_Integer entry)
 	{
-		lua_rawgeti(L, -1, eDOffset);	// data, key[, value], D, D[key], offset
-		lua_rawgeti(L, -2, eDType);	// data, key[, value], D, D[key], offset, type
+		#define I_(t) lua_pushinteger(L, lua_Integer(*reinterpret_cast<t*>(pField)))
+		#define N_(t) lua_pushnumber(L, lua_Number(*reinterpret_cast<t*>(pField)))
 
-		return PU8(L, 1) + U(L, -2);
-	}
-
-	#define F_(t, p) lua_pushnumber(L, *(t*)p)
-	#define I_(t, p) lua_pushinteger(L, *(t*)p)
-
-	/// @brief Indexes a member
-	/// @note upvalue 1: Member descriptor, non-permissions, and lookup data
-	static void IndexMember (lua_State * L)
-	{
-		// Point to the requested member.
-		Uint8 * pData = GetFields(L);	// data, key, D, D[key], offset, type
+		Uint8 * pField = pData + (entry >> TypeBits);
 
-		// Return the appropriate type.
-		switch (U(L, 6))
+		switch (entry & ((1 << TypeBits) - 1))
 		{
 		case Member_Reg::ePointer:
-			lua_pushlightuserdata(L, *(void**)pData);	// data, key, D, D[key], offset, type, pointer
-			break;
-		case Member_Reg::eU8:
-			I_(Uint8, pData);	// data, key, D, D[key], offset, type, u8
+			lua_pushlightuserdata(L, *reinterpret_cast<void**>(pField));
 			break;
 		case Member_Reg::eS8:
-			I_(Sint8, pData);	// data, key, D, D[key], offset, type, s8
-			break;
-		case Member_Reg::eU16:
-			I_(Uint16, pData);	// data, key, D, D[key], offset, type, u16
+			I_(Sint8);
 			break;
 		case Member_Reg::eS16:
-			I_(Sint16, pData);	// data, key, D, D[key], offset, type, s16
-			break;
-		case Member_Reg::eU32:
-			I_(Uint32, pData);	// data, key, D, D[key], offset, type, u32
+			I_(Sint16);
 			break;
 		case Member_Reg::eS32:
-			I_(Sint32, pData);	// data, key, D, D[key], offset, type, s32
+			I_(Sint32);
 			break;
-		case Member_Reg::eUChar:
-			I_(unsigned char, pData);	// data, key, D, D[key], offset, type, uchar
+		case Member_Reg::eS64:
+			N_(Sint64);
 			break;
-		case Member_Reg::eSChar:
-			I_(signed char, pData);	// data, key, D, D[key], offset, type, schar
+		case Member_Reg::eU8:
+			I_(Uint8);
 			break;
-		case Member_Reg::eUShort:
-			I_(unsigned short, pData);	// data, key, D, D[key], offset, type, ushort
+		case Member_Reg::eU16:
+			I_(Uint16);
 			break;
-		case Member_Reg::eSShort:
-			I_(signed short, pData);	// data, key, D, D[key], offset, type, sshort
+		case Member_Reg::eU32:
+			I_(Uint32);
 			break;
-		case Member_Reg::eULong:
-			I_(unsigned long, pData);	// data, key, D, D[key], offset, type, ulong
+		case Member_Reg::eU64:
+			N_(Uint64);
 			break;
-		case Member_Reg::eSLong:
-			I_(signed long, pData);	// data, key, D, D[key], offset, type, slong
+		case Member_Reg::eSChar:
+			I_(signed char);
 			break;
-		case Member_Reg::eUInt:
-			I_(unsigned int, pData);// data, key, D, D[key], offset, type, uint
+		case Member_Reg::eSShort:
+			I_(signed short);
+			break;
+		case Member_Reg::eSLong:
+			I_(signed long);
 			break;
 		case Member_Reg::eSInt:
-			I_(signed int, pData);	// data, key, D, D[key], offset, type, sint
+			I_(signed int);
 			break;
-		case Member_Reg::eFSingle:	
-			F_(float, pData);	// data, key, D, D[key], offset, type, fsingle
+		case Member_Reg::eUChar:
+			I_(unsigned char);
 			break;
-		case Member_Reg::eFDouble:
-			F_(double, pData);	// data, key, D, D[key], offset, type, fdouble
+		case Member_Reg::eUShort:
+			I_(unsigned short);
+			break;
+		case Member_Reg::eULong:
+			I_(unsigned long);
+			break;
+		case Member_Reg::eUInt:
+			I_(unsigned int);
 			break;
 		case Member_Reg::eString:
-			lua_pushstring(L, *(char**)pData);	// data, key, D, D[key], offset, type, string
+			lua_pushstring(L, *reinterpret_cast<char**>(pField));
 			break;
 		case Member_Reg::eBoolean:
-			lua_pushboolean(L, *(bool*)pData);	// data, key, D, D[key], offset, type, boolean
+			lua_pushboolean(L, *reinterpret_cast<bool*>(pField));
+			break;
+		case Member_Reg::eFSingle:
+			N_(float);
+			break;
+		case Member_Reg::eFDouble:
+			N_(double);
 			break;
-		default:
-			lua_pushnil(L);	// data, key, D, D[key], offset, type, nil
 		}
-	}
 
-	#undef F_
-	#undef I_
+		#undef I_
+		#undef N_
+	}
 
-	/// @brief Assigns to a member
-	/// @note upvalue 1: Member descriptor, non-permissions, and lookup data
-	static void NewIndexMember (lua_State * L)
+	/// @brief Writes a member
+	/// @param pData Member data
+	/// @param entry Member entry
+	/// @note object, key, value: Object being accessed, lookup key, value to assign
+	static void SetMember (lua_State * L, Uint8 * pData, lua_Integer entry)
 	{
-		// Point to the requested member.
-		Uint8 * pData = GetFields(L);	// data, key, value, D, D[key], offset, type
+		#define I_(t) *reinterpret_cast<t*>(pField) = static_cast<t>(luaL_checkinteger(L, 3))
+		#define N_(t) *reinterpret_cast<t*>(pField) = static_cast<t>(luaL_checknumber(L, 3))
+
+		Uint8 * pField = pData + (entry >> TypeBits);
 
-		// Assign the appropriate type.
-		switch (U(L, 7))
+		switch (entry & ((1 << TypeBits) - 1))
 		{
 		case Member_Reg::ePointer:
-			*(void**)pData = UD(L, 3);
-			break;
-		case Member_Reg::eU8:
-		case Member_Reg::eUChar:
-			*(Uint8*)pData = U8(L, 3);
+			*reinterpret_cast<void**>(pField) = UD(L, 3);
 			break;
 		case Member_Reg::eS8:
-		case Member_Reg::eSChar:
-		//	*(Sint8*)pData = S8(L, 3);
-			break;
-		case Member_Reg::eU16:
-		case Member_Reg::eUShort:
-			*(Uint16*)pData = U16(L, 3);
+			I_(Sint8);
 			break;
 		case Member_Reg::eS16:
-		case Member_Reg::eSShort:
-			*(Sint16*)pData = S16(L, 3);
+			I_(Sint16);
+			break;
+		case Member_Reg::eS32:
+			I_(Sint32);
+			break;
+		case Member_Reg::eS64:
+			N_(Sint64);
+			break;
+		case Member_Reg::eU8:
+			I_(Uint8);
+			break;
+		case Member_Reg::eU16:
+			I_(Uint16);
 			break;
 		case Member_Reg::eU32:
-			*(Uint32*)pData = U(L, 3);
+			I_(Uint32);
 			break;
-		case Member_Reg::eS32:
-			*(Sint32*)pData = S32(L, 3);
+		case Member_Reg::eU64:
+			N_(Uint64);
 			break;
-		case Member_Reg::eULong:
+		case Member_Reg::eSChar:
+			I_(signed char);
 			break;
-		case Member_Reg::eSLong:
-			*(long*)pData = LI(L, 3);
+		case Member_Reg::eSShort:
+			I_(signed short);
 			break;
-		case Member_Reg::eUInt:
+		case Member_Reg::eSLong:
+			I_(signed long);
 			break;
 		case Member_Reg::eSInt:
-			*(Sint32*)pData = S32(L, 3);
+			I_(signed int);
 			break;
-		case Member_Reg::eFSingle:
-			*(float*)pData = F(L, 3);
+		case Member_Reg::eUChar:
+			I_(unsigned char);
 			break;
-		case Member_Reg::eFDouble:
+		case Member_Reg::eUShort:
+			I_(unsigned short);
 			break;
-		case Member_Reg::eString:
+		case Member_Reg::eULong:
+			I_(unsigned long);
+			break;
+		case Member_Reg::eUInt:
+			I_(unsigned int);
 			break;
 		case Member_Reg::eBoolean:
-			*(bool*)pData = B(L, 3);
+			*reinterpret_cast<bool*>(pField) = B(L, 3);
+			break;
+		case Member_Reg::eFSingle:
+			N_(float);
+			break;
+		case Member_Reg::eFDouble:
+			N_(double);
 			break;
 		}
+
+		#undef I_
+		#undef N_
 	}
 
 	/// @brief Looks up member data
-	/// @note upvalue 1: Member descriptor, non-permissions, and lookup data
-	static void Lookup (lua_State * L)
+	/// @return Member data
+	/// @note upvalue 3: Lookup key
+	/// @note object: Object being accessed
+	template<int lookup> static Uint8 * Lookup (lua_State * L)
 	{
-		lua_rawgeti(L, lua_upvalueindex(1), eLookup);	// object, key[, value], lookup
-		lua_rawgeti(L, -1, eLType);	// object, key[, value], lookup, type
+		void * pData = 0;
 
-		lua_Integer type = lua_tointeger(L, -1);
+		switch (lookup)
+		{
+		case eThis:
+			pData = lua_touserdata(L, 1);
+			break;
+		case eRegistry:
+			lua_pushvalue(L, 1);// object, ..., object
+			lua_gettable(L, LUA_REGISTRYINDEX);	// object, ..., data
+			pData = lua_touserdata(L, -1);
+			lua_pop(L, 1);	// object, ...
+			break;
+		case ePointerTo:
+			pData = *(void**)UD(L, 1);
+			break;
+		case eKey:
+			lua_pushvalue(L, lua_upvalueindex(eLKey));	// object, ..., where
+			lua_gettable(L, 1);	// object, ..., data
+			pData = lua_touserdata(L, -1);
+			lua_pop(L, 1);	// object, ...
+			break;
+		}
 
-		lua_pop(L, 1);	// object, key[, value], lookup
+		return static_cast<Uint8*>(pData);
+	}
 
-		switch (type)
+	/// @brief Pushes member data, for a getter or setter function
+	/// @param object Stack index of object being accessed
+	/// @note upvalue 2: Lookup type
+	/// @note upvalue 3: Lookup key
+	static void PushData (lua_State * L, int object)
+	{
+		switch (lua_tointeger(L, lua_upvalueindex(eLType)))
 		{
 		case eThis:
+			lua_pushvalue(L, object);	// ..., object
+			break;
 		case eRegistry:
-			lua_pushvalue(L, 1);// object, key[, value], lookup, object
-
-			if (eRegistry == type) lua_gettable(L, LUA_REGISTRYINDEX);	// object, key[, value], lookup, data;
+			lua_pushvalue(L, object);	// ..., object
+			lua_gettable(L, LUA_REGISTRYINDEX);	// ..., data
 			break;
 		case ePointerTo:
-			lua_pushlightuserdata(L, *(void**)UD(L, 1));// object, key[, value], lookup, data
+			lua_pushlightuserdata(L, *(void**)UD(L, object));	// ..., data
 			break;
 		case eKey:
-			lua_rawgeti(L, -2, eLKey);	// object, key[, value], lookup, key
-			lua_gettable(L, 1);	// object, key[, value], lookup, data
+			lua_pushvalue(L, lua_upvalueindex(eLKey));	// ..., where
+			lua_gettable(L, object);// ..., data
 			break;
 		}
-
-		lua_replace(L, -2);	// object, key[, value], data
 	}
 
-	/// @brief __index closure
-	/// @note upvalue 1: Member descriptor, non-permissions, and lookup data
-	/// @note upvalue 2: Member getter table
+	/// @brief __index closure, specialized to the lookup type
+	/// @note upvalue 1: Getter table
+	/// @note upvalue 2: Lookup type
+	/// @note upvalue 3: Lookup key
 	/// @note object: Object being accessed
 	/// @note key: Lookup key
-	static int Index (lua_State * L)
+	template<int lookup> static int Index (lua_State * L)
 	{
-		Lookup(L);	// object, key, data
+		lua_pushvalue(L, 2);// object, key, key
+		lua_rawget(L, lua_upvalueindex(eAccessors));// object, key, getter
 
-		//
-		lua_pushvalue(L, 2);// object, key, data, key
-		lua_gettable(L, lua_upvalueindex(2));	// object, key, data, getter
-
-		if (!lua_isnil(L, 4))
+		// Members are read in place. Getter functions are given the data.
+		if (lua_type(L, 3) == LUA_TNUMBER)
 		{
-			lua_insert(L, 1);	// getter, object, key, data
-			lua_call(L, 3, 1);	// result
+			GetMember(L, Lookup<lookup>(L), lua_tointeger(L, 3));	// object, key, entry, value
+
+			return 1;
 		}
 
-		//
-		else
-		{
-			lua_pop(L, 1);	// object, key, data
-			lua_replace(L, 1);	// data, key
-			
-			lua_rawgeti(L, lua_upvalueindex(1), eNoRead);	// data, key, noread
-			lua_pushvalue(L, 2);// data, key, noread, key
-			lua_gettable(L, 3);	// data, key, noread, bNoRead
-
-			if (!lua_toboolean(L, 4))
-			{
-				//
-				lua_pop(L, 2);	// data, key
-				lua_rawgeti(L, lua_upvalueindex(1), eDescriptors);	// data, key, D
-				lua_pushvalue(L, 2);// data, key, D, key
-				lua_gettable(L, 3);	// data, key, D, D[key]
+		if (lua_isnil(L, 3)) return 1;
 
-				if (!lua_isnil(L, 4)) IndexMember(L);	// result
-			}
-		}
+		lua_insert(L, 1);	// getter, object, key
+
+		PushData(L, 2);	// getter, object, key, data
+
+		lua_call(L, 3, 1);	// result
 
 		return 1;
 	}
 
-	/// @brief __newindex closure
-	/// @note upvalue 1: Member descriptor, non-permissions, and lookup data
-	/// @note upvalue 2: Member setter table
-	/// @note upvalue 3: Propagation boolean
+	/// @brief __newindex closure, specialized to the lookup type
+	/// @note upvalue 1: Setter table
+	/// @note upvalue 2: Lookup type
+	/// @note upvalue 3: Lookup key
+	/// @note upvalue 4: Propagation boolean
 	/// @note object: Object being accessed
 	/// @note key: Lookup key
 	/// @note value: Value to assign
-	static int NewIndex (lua_State * L)
+	template<int lookup> static int NewIndex (lua_State * L)
 	{
-		Lookup(L);	// object, key, value, data
-
-		//
-		lua_pushvalue(L, 2);// object, key, value, data, key
-		lua_gettable(L, lua_upvalueindex(2));	// object, key, value, data, setter
+		lua_pushvalue(L, 2);// object, key, value, key
+		lua_rawget(L, lua_upvalueindex(eAccessors));// object, key, value, setter
 
-		if (!lua_isnil(L, 5))
+		// Members are written in place, unless read-only. Setter functions are given the data.
+		switch (lua_type(L, 4))
 		{
-			lua_insert(L, 1);	// setter, object, key, value, data
-			lua_call(L, 4, 1);	// result
-
-			if (!lua_isnil(L, 1) && lua_toboolean(L, lua_upvalueindex(3))) return 1;
+		case LUA_TNUMBER:
+			SetMember(L, Lookup<lookup>(L), lua_tointeger(L, 4));
+
+			return 0;
+		case LUA_TBOOLEAN:
+			return luaL_error(L, "Member \"%s\" is read-only", lua_tostring(L, 2));
+		case LUA_TNIL:
+			return lua_toboolean(L, lua_upvalueindex(ePropagate)) ? 1 : 0;
 		}
 
-		//
-		else
-		{
-			lua_pop(L, 1);	// object, key, value, data
-			lua_replace(L, 1);	// data, key, value
-			lua_rawgeti(L, lua_upvalueindex(1), eNoWrite);	// data, key, value, nowrite
-			lua_pushvalue(L, 2);// data, key, value, nowrite, key
-			lua_gettable(L, 4);	// data, key, value, nowrite, bNoWrite
+		lua_insert(L, 1);	// setter, object, key, value
 
-			if (!lua_toboolean(L, 5))
-			{
-				//
-				lua_pop(L, 2);	// data, key, value
-				lua_rawgeti(L, lua_upvalueindex(1), eDescriptors);	// data, key, value, D
-				lua_pushvalue(L, 2);// data, key, value, D, key
-				lua_gettable(L, 4);	// data, key, value, D, D[key]
+		PushData(L, 2);	// setter, object, key, value, data
 
-				if (!lua_isnil(L, 5)) NewIndexMember(L);
+		lua_call(L, 4, 1);	// result
 
-				else if (lua_toboolean(L, lua_upvalueindex(3))) return 1;
-			}
-		}
-
-		return 0;
+		return !lua_isnil(L, 1) && lua_toboolean(L, lua_upvalueindex(ePropagate)) ? 1 : 0;
 	}
 
 	/// @brief Pushes __index and __newindex member binding closures onto stack
@@ -302,76 +306,88 @@ namespace Lua
 	/// @param count Count of member descriptors
 	/// @param lookup Means of datum lookup
 	/// @param where [optional] If lookup is eKey, used as lookup key
-	/// @param bPropagateOnFail If true, __newindex calls will propagate if no setter or member exists
+	/// @param bPropagateOnFail If true, __newindex calls will propagate if no setter or member exists; writes
+	///                         to read-only members are always rejected with an error
 	/// @note At least one of getters, setters, or members must be non-0 (if members, count must also be non-0)
+	/// @note Each member is entered in the getter and setter tables by its offset and type, and is
+	///       read or written in place; a function of the same name in getters or setters overrides it
 	void MemberBindFuncs (lua_State * L, luaL_Reg const * getters, luaL_Reg const * setters, Member_Reg const * members, int count, Members_Lookup lookup, char const * where, bool bPropagateOnFail)
 	{
 		assert(0 == count || members != 0);
 		assert(where != 0 || lookup != eKey);
 		assert(getters != 0 || setters != 0 || (members != 0 && count > 0));
 
-		lua_createtable(L, 4, 0);	// data
-
-		//
-		lua_createtable(L, 0, count);	// data, M
-		lua_newtable(L);// data, M, RP
-		lua_newtable(L);// data, M, RP, WP
+		lua_createtable(L, 0, count);	// G
+		lua_createtable(L, 0, count);	// G, S
 
 		for (int index = 0; index < count; ++index)
 		{
-			// Install any permission information.
-			switch (members[index].mPermissions)
+			Member_Reg const & member = members[index];
+
+			assert(member.mType < 1 << TypeBits);
+
+			lua_Integer entry = lua_Integer(member.mOffset) << TypeBits | member.mType;
+
+			// Enter the member where its permissions allow. A member that cannot be assigned,
+			// such as a string, whose storage is not owned, is entered as false, so that writes
+			// are rejected rather than propagated as though no such member existed.
+			if (member.mPermissions != Member_Reg::eWO)
 			{
-			case Member_Reg::eRO:
-			case Member_Reg::eWO:
-				lua_pushstring(L, members[index].mName.c_str());// data, M, RP, WP, name
-				lua_pushboolean(L, true);	// data, M, RP, WP, name, true
-				lua_settable(L, Member_Reg::eRO == members[index].mPermissions ? -4 : -3);	// data, M, RP = { ..., name = true }, WP / data, M, RP, WP = { ..., name = true }
-				break;
+				lua_pushstring(L, member.mName.c_str());// G, S, name
+				lua_pushinteger(L, entry);	// G, S, name, entry
+				lua_rawset(L, -4);	// G = { ..., name = entry }, S
 			}
 
-			//
-			lua_pushstring(L, members[index].mName.c_str());	// data, M, RP, WP, name
-			lua_createtable(L, 2, 0);	// data, M, RP, WP, name, {}
-			lua_pushinteger(L, members[index].mOffset);	// data, M, RP, WP, name, D, offset
-			lua_pushinteger(L, members[index].mType);	// data, M, RP, WP, name, D, offset, type
-			lua_rawseti(L, -3, eDType);	// data, M, RP, WP, name, D = { type = type }, offset
-			lua_rawseti(L, -2, eDOffset);	// data, M, RP, WP, name, D = { type, offset = offset }
-			lua_settable(L, -5);// data, M = { ..., name = D }, RP, WP
+			lua_pushstring(L, member.mName.c_str());// G, S, name
+
+			if (Member_Reg::eRO == member.mPermissions || Member_Reg::eString == member.mType) lua_pushboolean(L, 0);	// G, S, name, false
+
+			else lua_pushinteger(L, entry);	// G, S, name, entry
+
+			lua_rawset(L, -3);	// G, S = { ..., name = entry or false }
 		}
 
-		lua_rawseti(L, -4, eNoWrite);	// data = { nowrite = WP }, M, RP
-		lua_rawseti(L, -3, eNoRead);// data = { nowrite, noread = RP }, M
-		lua_rawseti(L, -2, eDescriptors);	// data = { nowrite, noread, descriptors = M }
+		if (setters != 0) luaL_register(L, 0, setters);
+
+		lua_insert(L, -2);	// S, G
+
+		if (getters != 0) luaL_register(L, 0, getters);
 
-		//
-		lua_createtable(L, 2, 0);	// data, L
-		lua_pushinteger(L, lookup);	// data, L, lookup
-		lua_rawseti(L, -2, eLType);	// data, L = { type = lookup }
+		// Build __index closure, specialized to the lookup type.
+		lua_CFunction index = Index<eThis>, newindex = NewIndex<eThis>;
 
-		if (eKey == lookup)
+		switch (lookup)
 		{
-			lua_pushstring(L, where);	// data, L, where
-			lua_rawseti(L, -2, eLKey);	// data, L = { type, where = where }
+		case eRegistry:
+			index = Index<eRegistry>, newindex = NewIndex<eRegistry>;
+			break;
+		case ePointerTo:
+			index = Index<ePointerTo>, newindex = NewIndex<ePointerTo>;
+			break;
+		case eKey:
+			index = Index<eKey>, newindex = NewIndex<eKey>;
+			break;
+		default:
+			break;
 		}
 
-		lua_rawseti(L, -2, eLookup);// data = { nowrite, noread, descriptors, lookup = L }
+		lua_pushinteger(L, lookup);	// S, G, lookup
 
-		// Build __index closure.
-		lua_pushvalue(L, -1);	// data, data
-		lua_newtable(L);// data, data, {}
+		if (eKey == lookup) lua_pushstring(L, where);	// S, G, lookup, where
 
-		if (getters != 0) luaL_register(L, 0, getters);
+		else lua_pushnil(L);// S, G, lookup, nil
 
-		lua_pushcclosure(L, Index, 2);	// data, __index
+		lua_pushcclosure(L, index, 3);	// S, __index
 
 		// Build __newindex closure.
-		lua_insert(L, -2);	// __index, data
-		lua_newtable(L);// __index, data, {}
+		lua_insert(L, -2);	// __index, S
+		lua_pushinteger(L, lookup);	// __index, S, lookup
 
-		if (setters != 0) luaL_register(L, 0, setters);
+		if (eKey == lookup) lua_pushstring(L, where);	// __index, S, lookup, where
+
+		else lua_pushnil(L);// __index, S, lookup, nil
 
-		lua_pushboolean(L, bPropagateOnFail);	// __index, data, setters, bPropagateOnFail
-		lua_pushcclosure(L, NewIndex, 3);	// __index, __newindex
+		lua_pushboolean(L, bPropagateOnFail);	// __index, S, lookup, where, bPropagateOnFail
+		lua_pushcclosure(L, newindex, 4);	// __index, __newindex
 	}
 }
\ No newline at end of file
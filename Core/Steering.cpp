@@ -0,0 +1,295 @@
+#include "Steering.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Steering
+{
+	/// @brief Constructs an Accumulator object
+	/// @note The resolved force is not limited until a maximum is set
+	Accumulator::Accumulator (void) : mMax(0.0f), mLimited(false)
+	{
+	}
+
+	/// @brief Clears all forces
+	void Accumulator::Clear (void)
+	{
+		std::fill(mSet.begin(), mSet.end(), 0);
+	}
+
+	/// @brief Sets a channel's force
+	/// @param channel Channel index
+	/// @param force Force, which is scaled by the channel's scale
+	void Accumulator::Set (Uint channel, Vector const & force)
+	{
+		mForces[channel] = force * mScales[channel];
+		mSet[channel] = 1;
+	}
+
+	/// @brief Sets the greatest length of the resolved force
+	/// @param fMax Maximum length
+	/// @param bLimited If true, the length is limited; otherwise, the maximum is ignored
+	void Accumulator::SetMax (float fMax, bool bLimited)
+	{
+		mMax = fMax;
+		mLimited = bLimited;
+	}
+
+	/// @brief Sets the order in which channels are resolved
+	/// @param order Channel indices, by priority; channels left out are not resolved
+	/// @param count Count of indices
+	void Accumulator::SetOrder (Uint const * order, Uint count)
+	{
+		mOrder.assign(order, order + count);
+	}
+
+	/// @brief Sets a channel's scale
+	/// @param channel Channel index
+	/// @param fScale Scale applied to forces set afterward
+	void Accumulator::SetScale (Uint channel, float fScale)
+	{
+		mScales[channel] = fScale;
+	}
+
+	/// @brief Resolves the forces set since the last clear
+	/// @return Sum of forces, in channel order
+	/// @note If limited, each force is clamped to what remains of the maximum, as in
+	///       Vec.ClampToMax, and later channels are dropped once it is used up
+	Vector Accumulator::Resolve (void) const
+	{
+		Vector sum(0.0f, 0.0f, 0.0f);
+
+		for (Uint i = 0; i < mOrder.size(); ++i)
+		{
+			if (!mSet[mOrder[i]]) continue;
+
+			Vector force = mForces[mOrder[i]];
+
+			if (mLimited)
+			{
+				float fRemaining = mMax - sum.length();
+
+				if (fRemaining <= 0.0f) break;
+
+				if (force.length() > fRemaining) force = fRemaining * ~force;
+			}
+
+			sum = sum + force;
+		}
+
+		return sum;
+	}
+
+	/// @brief Adds a channel
+	/// @param fScale Scale applied to the channel's forces
+	/// @return Channel index
+	/// @note The channel is resolved after those already added, until the order is set
+	Uint Accumulator::AddChannel (float fScale)
+	{
+		Uint channel = GetChannelCount();
+
+		mForces.push_back(Vector(0.0f, 0.0f, 0.0f));
+		mScales.push_back(fScale);
+		mSet.push_back(0);
+		mOrder.push_back(channel);
+
+		return channel;
+	}
+
+	/// @brief Gets the count of channels
+	/// @return Channel count
+	Uint Accumulator::GetChannelCount (void) const
+	{
+		return Uint(mScales.size());
+	}
+
+	/// @brief Constructs a Flock object
+	Flock::Flock (void) : mCellSize(1.0f)
+	{
+	}
+
+	/// @brief Adds an agent
+	/// @param position Agent position
+	/// @param heading Agent heading
+	/// @param fRange Distance within which other agents are neighbors
+	/// @note Agents are indexed in the order added
+	void Flock::Add (Vector const & position, Vector const & heading, float fRange)
+	{
+		mX.push_back(position.m[0]);
+		mY.push_back(position.m[1]);
+		mZ.push_back(position.m[2]);
+		mHX.push_back(heading.m[0]);
+		mHY.push_back(heading.m[1]);
+		mHZ.push_back(heading.m[2]);
+		mRange.push_back(fRange);
+	}
+
+	/// @brief Removes all agents
+	void Flock::Clear (void)
+	{
+		mX.clear();
+		mY.clear();
+		mZ.clear();
+		mHX.clear();
+		mHY.clear();
+		mHZ.clear();
+		mRange.clear();
+		mCounts.clear();
+	}
+
+	/// @brief Finds every agent's neighbors and group forces
+	/// @note Agents are hashed into cells as wide as the greatest range, so each agent's
+	///       neighbors lie in the cells around its own
+	void Flock::Update (void)
+	{
+		Uint count = GetCount();
+
+		for (int c = 0; c < eChannelCount; ++c)
+		{
+			mFX[c].assign(count, 0.0f);
+			mFY[c].assign(count, 0.0f);
+			mFZ[c].assign(count, 0.0f);
+		}
+
+		mCounts.assign(count, 0);
+
+		if (0 == count) return;
+
+		// Size the cells and the table, keeping at least twice as many buckets as agents.
+		mCellSize = *std::max_element(mRange.begin(), mRange.end());
+
+		if (mCellSize <= 0.0f) mCellSize = 1.0f;
+
+		Uint nbuckets = 1;
+
+		while (nbuckets < 2 * count) nbuckets *= 2;
+
+		// Sort the agents into buckets.
+		mBuckets.resize(count);
+		mStarts.assign(nbuckets + 1, 0);
+		mSorted.resize(count);
+
+		for (Uint i = 0; i < count; ++i)
+		{
+			mBuckets[i] = Hash(Cell(mX[i]), Cell(mY[i]), Cell(mZ[i])) & (nbuckets - 1);
+
+			++mStarts[mBuckets[i] + 1];
+		}
+
+		for (Uint b = 0; b < nbuckets; ++b) mStarts[b + 1] += mStarts[b];
+
+		for (Uint i = 0; i < count; ++i) mSorted[mStarts[mBuckets[i]]++] = i;
+
+		for (Uint b = nbuckets; b > 0; --b) mStarts[b] = mStarts[b - 1];
+
+		mStarts[0] = 0;
+
+		// Gather each agent's neighbors from the buckets of the cells around it. Distinct
+		// cells may share a bucket, so each bucket is only visited once.
+		for (Uint i = 0; i < count; ++i)
+		{
+			float fX = mX[i], fY = mY[i], fZ = mZ[i], fR2 = mRange[i] * mRange[i];
+			float fHX = 0.0f, fHY = 0.0f, fHZ = 0.0f, fCX = 0.0f, fCY = 0.0f, fCZ = 0.0f, fSX = 0.0f, fSY = 0.0f, fSZ = 0.0f;
+
+			int x = Cell(fX), y = Cell(fY), z = Cell(fZ);
+
+			Uint visited[27], nvisited = 0, nneighbors = 0;
+
+			for (int dx = -1; dx <= 1; ++dx)
+			{
+				for (int dy = -1; dy <= 1; ++dy)
+				{
+					for (int dz = -1; dz <= 1; ++dz)
+					{
+						Uint bucket = Hash(x + dx, y + dy, z + dz) & (nbuckets - 1);
+
+						if (std::find(visited, visited + nvisited, bucket) != visited + nvisited) continue;
+
+						visited[nvisited++] = bucket;
+
+						for (Uint k = mStarts[bucket]; k < mStarts[bucket + 1]; ++k)
+						{
+							Uint j = mSorted[k];
+
+							float fOX = fX - mX[j], fOY = fY - mY[j], fOZ = fZ - mZ[j], fD2 = fOX * fOX + fOY * fOY + fOZ * fOZ;
+
+							if (j == i || fD2 >= fR2) continue;
+
+							++nneighbors;
+
+							fHX += mHX[j];
+							fHY += mHY[j];
+							fHZ += mHZ[j];
+							fCX += mX[j];
+							fCY += mY[j];
+							fCZ += mZ[j];
+
+							// Push away from the neighbor, inverted through the unit sphere.
+							if (fD2 > 0.0f)
+							{
+								fSX += fOX / fD2;
+								fSY += fOY / fD2;
+								fSZ += fOZ / fD2;
+							}
+						}
+					}
+				}
+			}
+
+			mCounts[i] = nneighbors;
+
+			if (0 == nneighbors) continue;
+
+			float fN = float(nneighbors);
+
+			mFX[eAlignment][i] = fHX / fN - mHX[i];
+			mFY[eAlignment][i] = fHY / fN - mHY[i];
+			mFZ[eAlignment][i] = fHZ / fN - mHZ[i];
+			mFX[eCohesion][i] = fCX / fN - fX;
+			mFY[eCohesion][i] = fCY / fN - fY;
+			mFZ[eCohesion][i] = fCZ / fN - fZ;
+			mFX[eSeparation][i] = fSX;
+			mFY[eSeparation][i] = fSY;
+			mFZ[eSeparation][i] = fSZ;
+		}
+	}
+
+	/// @brief Gets an agent's group force, as of the last update
+	/// @param index Agent index
+	/// @param channel Force channel
+	/// @return Force; if the agent has no neighbors, the zero vector
+	Vector Flock::GetForce (Uint index, Channel channel) const
+	{
+		return Vector(mFX[channel][index], mFY[channel][index], mFZ[channel][index]);
+	}
+
+	/// @brief Gets the count of agents
+	/// @return Agent count
+	Uint Flock::GetCount (void) const
+	{
+		return Uint(mX.size());
+	}
+
+	/// @brief Gets an agent's neighbor count, as of the last update
+	/// @param index Agent index
+	/// @return Neighbor count
+	Uint Flock::GetNeighborCount (Uint index) const
+	{
+		return mCounts[index];
+	}
+
+	/// @brief Hashes a cell
+	/// @param x, y, z Cell coordinates
+	/// @return Hash value
+	Uint Flock::Hash (int x, int y, int z) const
+	{
+		return (Uint(x) * 73856093U) ^ (Uint(y) * 19349663U) ^ (Uint(z) * 83492791U);
+	}
+
+	/// @brief Gets the cell coordinate of a position component
+	/// @param fX Component
+	/// @return Cell coordinate
+	int Flock::Cell (float fX) const
+	{
+		return int(floorf(fX / mCellSize));
+	}
+}
\ No newline at end of file
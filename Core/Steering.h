@@ -0,0 +1,80 @@
+#ifndef STEERING_H
+#define STEERING_H
+
+#include "App.h"
+#include <vector>
+
+namespace Steering
+{
+	typedef Lua::Uint Uint;
+	typedef Lua::AppTypes::Vector Vector;
+
+	/// @brief Group force channels
+	enum Channel {
+		eAlignment,	///< Average neighbor heading, less the agent's own
+		eCohesion,	///< Offset to the neighbors' center
+		eSeparation,///< Sum of pushes away from each neighbor, falling off with distance
+		eChannelCount
+	};
+
+	/// @brief Forces gathered on separate channels, each with its own scale, and resolved in
+	///        order of priority
+	class Accumulator {
+	private:
+	// Members
+		std::vector<Vector> mForces;///< Scaled forces, by channel
+		std::vector<float> mScales;	///< Scales, by channel
+		std::vector<Uint8> mSet;///< Per channel, if nonzero, a force was set since the last clear
+		std::vector<Uint> mOrder;	///< Channels, in order of priority
+		float mMax;	///< Greatest length of the resolved force, if limited
+		bool mLimited;	///< If true, the resolved force is limited
+	public:
+	// Lifetime
+		Accumulator (void);
+	// Interface
+		void Clear (void);
+		void Set (Uint channel, Vector const & force);
+		void SetMax (float fMax, bool bLimited);
+		void SetOrder (Uint const * order, Uint count);
+		void SetScale (Uint channel, float fScale);
+
+		Vector Resolve (void) const;
+
+		Uint AddChannel (float fScale);
+		Uint GetChannelCount (void) const;
+	};
+
+	/// @brief Agents whose group forces are found together, with neighbors found through a
+	///        spatial hash
+	class Flock {
+	private:
+	// Members
+		std::vector<float> mX, mY, mZ;	///< Agent positions
+		std::vector<float> mHX, mHY, mHZ;	///< Agent headings
+		std::vector<float> mRange;	///< Agent neighbor ranges
+		std::vector<float> mFX[eChannelCount], mFY[eChannelCount], mFZ[eChannelCount];	///< Agent forces, by channel
+		std::vector<Uint> mCounts;	///< Agent neighbor counts
+		std::vector<Uint> mBuckets;	///< Agent hash buckets
+		std::vector<Uint> mStarts;	///< Per bucket, offset of its first agent in the sorted list; one past the end closes the last
+		std::vector<Uint> mSorted;	///< Agents, sorted by bucket
+		float mCellSize;///< Hash cell size
+	// Methods
+		Uint Hash (int x, int y, int z) const;
+
+		int Cell (float fX) const;
+	public:
+	// Lifetime
+		Flock (void);
+	// Interface
+		void Add (Vector const & position, Vector const & heading, float fRange);
+		void Clear (void);
+		void Update (void);
+
+		Vector GetForce (Uint index, Channel channel) const;
+
+		Uint GetCount (void) const;
+		Uint GetNeighborCount (Uint index) const;
+	};
+}
+
+#endif // STEERING_H
\ No newline at end of file
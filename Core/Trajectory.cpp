@@ -0,0 +1,489 @@
+#include "Trajectory.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define TRAJECTORY_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace Trajectory
+{
+	/// @brief Pi, as used to bound launch angles
+	static const float fPi = 3.14159f;
+	static const float fHalfPi = fPi / 2;
+
+	/// @brief Sine series coefficients; over launch angles, the error is within 6e-8
+	static const float fS3 = -1.0f / 6.0f, fS5 = 1.0f / 120.0f, fS7 = -1.0f / 5040.0f, fS9 = 1.0f / 362880.0f, fS11 = -1.0f / 39916800.0f;
+
+	/// @brief Arcsine polynomial coefficients (Abramowitz and Stegun 4.4.46); the error is
+	///        within 2e-8
+	static const float fA0 = 1.5707963050f, fA1 = -0.2145988016f, fA2 = 0.0889789874f, fA3 = -0.0501743046f;
+	static const float fA4 = 0.0308918810f, fA5 = -0.0170881256f, fA6 = 0.0066700901f, fA7 = -0.0012624911f;
+	static const float fArcHalfPi = 1.5707963268f;
+
+	/// @brief Approximates an arcsine
+	/// @param fX Value in [-1, 1]
+	/// @return Arcsine of value
+	float ASin (float fX)
+	{
+		float fAX = fabsf(fX);
+		float fP = fA0 + fAX * (fA1 + fAX * (fA2 + fAX * (fA3 + fAX * (fA4 + fAX * (fA5 + fAX * (fA6 + fAX * fA7))))));
+		float fR = fArcHalfPi - sqrtf(1.0f - fAX) * fP;
+
+		return fX < 0.0f ? -fR : fR;
+	}
+
+	/// @brief Approximates a sine
+	/// @param fA Angle in [-pi / 2, +pi / 2]
+	/// @return Sine of angle
+	float Sin (float fA)
+	{
+		float fA2 = fA * fA;
+
+		return fA + fA * fA2 * (fS3 + fA2 * (fS5 + fA2 * (fS7 + fA2 * (fS9 + fA2 * fS11))));
+	}
+
+	/// @brief Indicates whether a launch angle is valid
+	/// @param fA Launch angle
+	/// @return If true, the angle is valid
+	static bool ValidAngle (float fA)
+	{
+		return fA > -fHalfPi && fA < +fHalfPi;
+	}
+
+#ifdef TRAJECTORY_SSE2
+	/// @brief Selects between two registers, lane by lane
+	/// @param mask Lanes to take from the first register
+	/// @param a First register
+	/// @param b Second register
+	/// @return Register with selected lanes
+	static __m128 Select (__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	/// @brief Approximates four arcsines, as in ASin
+	/// @param x Values in [-1, 1]
+	/// @return Arcsines of values
+	static __m128 ASin4 (__m128 x)
+	{
+		__m128 sign = _mm_and_ps(x, _mm_set1_ps(-0.0f)), ax = _mm_xor_ps(x, sign);
+		__m128 p = _mm_set1_ps(fA7);
+
+		p = _mm_add_ps(_mm_set1_ps(fA6), _mm_mul_ps(ax, p));
+		p = _mm_add_ps(_mm_set1_ps(fA5), _mm_mul_ps(ax, p));
+		p = _mm_add_ps(_mm_set1_ps(fA4), _mm_mul_ps(ax, p));
+		p = _mm_add_ps(_mm_set1_ps(fA3), _mm_mul_ps(ax, p));
+		p = _mm_add_ps(_mm_set1_ps(fA2), _mm_mul_ps(ax, p));
+		p = _mm_add_ps(_mm_set1_ps(fA1), _mm_mul_ps(ax, p));
+		p = _mm_add_ps(_mm_set1_ps(fA0), _mm_mul_ps(ax, p));
+
+		__m128 r = _mm_sub_ps(_mm_set1_ps(fArcHalfPi), _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), ax)), p));
+
+		return _mm_xor_ps(r, sign);
+	}
+
+	/// @brief Approximates four sines, as in Sin
+	/// @param a Angles in [-pi / 2, +pi / 2]
+	/// @return Sines of angles
+	static __m128 Sin4 (__m128 a)
+	{
+		__m128 a2 = _mm_mul_ps(a, a), p = _mm_set1_ps(fS11);
+
+		p = _mm_add_ps(_mm_set1_ps(fS9), _mm_mul_ps(a2, p));
+		p = _mm_add_ps(_mm_set1_ps(fS7), _mm_mul_ps(a2, p));
+		p = _mm_add_ps(_mm_set1_ps(fS5), _mm_mul_ps(a2, p));
+		p = _mm_add_ps(_mm_set1_ps(fS3), _mm_mul_ps(a2, p));
+
+		return _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(a, a2), p));
+	}
+
+	/// @brief Finds which of four launch angles are valid
+	/// @param a Launch angles
+	/// @return Mask of valid angles
+	static __m128 ValidAngle4 (__m128 a)
+	{
+		return _mm_and_ps(_mm_cmpgt_ps(a, _mm_set1_ps(-fHalfPi)), _mm_cmplt_ps(a, _mm_set1_ps(+fHalfPi)));
+	}
+#endif
+
+	/// @brief Finds the launch angles that reach a target point, for each of several speeds
+	/// @param fX Horizontal distance to target
+	/// @param fY Height of target
+	/// @param speeds Launch speeds
+	/// @param fG Gravity force
+	/// @param count Count of speeds
+	/// @param lo [out] Per speed, the lesser angle, or the only one; fNone if there is none
+	/// @param hi [out] Per speed, the greater angle, if there are two; otherwise, fNone
+	/// @note This follows Trajectory.GetAngles, with approximate arcsines
+	void GetAngles (float fX, float fY, float const * speeds, float fG, Uint count, float * lo, float * hi)
+	{
+		if (fX < 0.0f || fG <= 0.0f)
+		{
+			std::fill(lo, lo + count, fNone);
+			std::fill(hi, hi + count, fNone);
+
+			return;
+		}
+
+		// The angle to the target is the same for every speed.
+		float fX2 = fX * fX, fRadius = sqrtf(fX2 + fY * fY), fIncline = ASin(fY / fRadius);
+
+		Uint index = 0;
+
+#ifdef TRAJECTORY_SSE2
+		__m128 y = _mm_set1_ps(fY), gx2 = _mm_set1_ps(fG * fX2), radius = _mm_set1_ps(fRadius), incline = _mm_set1_ps(fIncline);
+		__m128 half = _mm_set1_ps(0.5f), pi = _mm_set1_ps(fPi), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), none = _mm_set1_ps(fNone);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			// Keep speeds whose angles lie in the bounding parabola.
+			__m128 v = _mm_loadu_ps(speeds + index);
+			__m128 numerator = _mm_add_ps(y, _mm_div_ps(gx2, _mm_mul_ps(v, v)));
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(v, zero), _mm_cmple_ps(numerator, radius));
+
+			// Solve for both angles, and keep those in the right semicircle, in order.
+			__m128 term = ASin4(_mm_max_ps(_mm_min_ps(_mm_div_ps(numerator, radius), one), _mm_sub_ps(zero, one)));
+			__m128 a0 = _mm_mul_ps(half, _mm_add_ps(term, incline));
+			__m128 a1 = _mm_mul_ps(_mm_sub_ps(zero, half), _mm_sub_ps(_mm_sub_ps(term, incline), pi));
+			__m128 ok0 = _mm_and_ps(valid, ValidAngle4(a0)), ok1 = _mm_and_ps(valid, ValidAngle4(a1)), both = _mm_and_ps(ok0, ok1);
+
+			_mm_storeu_ps(lo + index, Select(both, _mm_min_ps(a0, a1), Select(ok0, a0, Select(ok1, a1, none))));
+			_mm_storeu_ps(hi + index, Select(both, _mm_max_ps(a0, a1), none));
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			float fV = speeds[index], fNumerator = fY + fG * fX2 / (fV * fV);
+
+			lo[index] = hi[index] = fNone;
+
+			if (fV <= 0.0f || fNumerator > fRadius) continue;
+
+			float fTerm = ASin(std::max(std::min(fNumerator / fRadius, 1.0f), -1.0f));
+			float fA0 = +0.5f * (fTerm + fIncline), fA1 = -0.5f * (fTerm - fIncline - fPi);
+
+			bool bOK0 = ValidAngle(fA0), bOK1 = ValidAngle(fA1);
+
+			if (bOK0 && bOK1) lo[index] = std::min(fA0, fA1), hi[index] = std::max(fA0, fA1);
+
+			else if (bOK0) lo[index] = fA0;
+
+			else if (bOK1) lo[index] = fA1;
+		}
+	}
+
+	/// @brief Finds the peak heights of several launches
+	/// @param speeds Launch speeds
+	/// @param angles Launch angles
+	/// @param fG Gravity force
+	/// @param count Count of launches
+	/// @param heights [out] Per launch, peak height, or fNone if the launch is invalid
+	/// @note This follows Trajectory.GetMaxHeight, with approximate sines
+	void GetMaxHeights (float const * speeds, float const * angles, float fG, Uint count, float * heights)
+	{
+		if (fG <= 0.0f)
+		{
+			std::fill(heights, heights + count, fNone);
+
+			return;
+		}
+
+		Uint index = 0;
+
+#ifdef TRAJECTORY_SSE2
+		__m128 scale = _mm_set1_ps(0.5f / fG), zero = _mm_setzero_ps(), none = _mm_set1_ps(fNone);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			__m128 v = _mm_loadu_ps(speeds + index), a = _mm_loadu_ps(angles + index);
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(v, zero), ValidAngle4(a));
+			__m128 vs = _mm_mul_ps(v, Sin4(a));
+
+			// Downward launches peak at the start.
+			__m128 height = _mm_and_ps(_mm_cmpge_ps(a, zero), _mm_mul_ps(_mm_mul_ps(vs, vs), scale));
+
+			_mm_storeu_ps(heights + index, Select(valid, height, none));
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			float fV = speeds[index], fA = angles[index], fVS = fV * Sin(fA);
+
+			if (fV <= 0.0f || !ValidAngle(fA)) heights[index] = fNone;
+
+			else heights[index] = fA < 0.0f ? 0.0f : fVS * fVS * (0.5f / fG);
+		}
+	}
+
+	/// @brief Finds the positions of several launches at a given time
+	/// @param begin Start of trajectories
+	/// @param end Point that sets the trajectories' heading
+	/// @param speeds Launch speeds
+	/// @param angles Launch angles
+	/// @param fG Gravity force
+	/// @param fT Time along trajectories
+	/// @param count Count of launches
+	/// @param x [out] Per launch, x-coordinate of position, or fNone if the launch is invalid
+	/// @param y [out] Per launch, y-coordinate, likewise
+	/// @param z [out] Per launch, z-coordinate, likewise
+	/// @note This follows Trajectory.GetPosition, with approximate sines
+	void GetPositions (Vector const & begin, Vector const & end, float const * speeds, float const * angles, float fG, float fT, Uint count, float * x, float * y, float * z)
+	{
+		if (fG <= 0.0f || fT < 0.0f)
+		{
+			std::fill(x, x + count, fNone);
+			std::fill(y, y + count, fNone);
+			std::fill(z, z + count, fNone);
+
+			return;
+		}
+
+		// Every trajectory runs toward the end point.
+		Vector D = ~(end - begin).XZ();
+
+		Uint index = 0;
+
+#ifdef TRAJECTORY_SSE2
+		__m128 bx = _mm_set1_ps(begin.m[0]), by = _mm_set1_ps(begin.m[1]), bz = _mm_set1_ps(begin.m[2]), dx = _mm_set1_ps(D.m[0]), dz = _mm_set1_ps(D.m[2]);
+		__m128 t = _mm_set1_ps(fT), drop = _mm_set1_ps(0.5f * fG * fT), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), none = _mm_set1_ps(fNone);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			__m128 v = _mm_loadu_ps(speeds + index), a = _mm_loadu_ps(angles + index);
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(v, zero), ValidAngle4(a));
+			__m128 s = Sin4(a), c = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(s, s)), zero));
+
+			__m128 px = _mm_add_ps(bx, _mm_mul_ps(t, _mm_mul_ps(_mm_mul_ps(dx, v), c)));
+			__m128 py = _mm_add_ps(by, _mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(v, s), drop)));
+			__m128 pz = _mm_add_ps(bz, _mm_mul_ps(t, _mm_mul_ps(_mm_mul_ps(dz, v), c)));
+
+			_mm_storeu_ps(x + index, Select(valid, px, none));
+			_mm_storeu_ps(y + index, Select(valid, py, none));
+			_mm_storeu_ps(z + index, Select(valid, pz, none));
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			float fV = speeds[index], fA = angles[index];
+
+			if (fV <= 0.0f || !ValidAngle(fA))
+			{
+				x[index] = y[index] = z[index] = fNone;
+
+				continue;
+			}
+
+			float fSin = Sin(fA), fCos = sqrtf(std::max(1.0f - fSin * fSin, 0.0f));
+
+			x[index] = begin.m[0] + fT * (D.m[0] * fV * fCos);
+			y[index] = begin.m[1] + fT * (fV * fSin - 0.5f * fG * fT);
+			z[index] = begin.m[2] + fT * (D.m[2] * fV * fCos);
+		}
+	}
+
+	/// @brief Finds the launch speeds that reach a target point, for each of several angles
+	/// @param fX Horizontal distance to target
+	/// @param fY Height of target
+	/// @param angles Launch angles
+	/// @param fG Gravity force
+	/// @param count Count of angles
+	/// @param speeds [out] Per angle, launch speed, or fNone if the target is out of reach
+	/// @note This follows Trajectory.GetSpeed, with approximate sines
+	void GetSpeeds (float fX, float fY, float const * angles, float fG, Uint count, float * speeds)
+	{
+		if (fX < 0.0f || fG <= 0.0f)
+		{
+			std::fill(speeds, speeds + count, fNone);
+
+			return;
+		}
+
+		Uint index = 0;
+
+#ifdef TRAJECTORY_SSE2
+		__m128 x = _mm_set1_ps(fX), y = _mm_set1_ps(fY), g = _mm_set1_ps(0.5f * fG), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), none = _mm_set1_ps(fNone);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			__m128 a = _mm_loadu_ps(angles + index);
+			__m128 s = Sin4(a), c = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(s, s)), zero));
+			__m128 disc = _mm_sub_ps(_mm_mul_ps(x, s), _mm_mul_ps(y, c));
+			__m128 valid = _mm_and_ps(ValidAngle4(a), _mm_cmpge_ps(disc, zero));
+
+			_mm_storeu_ps(speeds + index, Select(valid, _mm_mul_ps(x, _mm_sqrt_ps(_mm_div_ps(g, _mm_mul_ps(disc, c)))), none));
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			float fA = angles[index], fSin = Sin(fA), fCos = sqrtf(std::max(1.0f - fSin * fSin, 0.0f));
+			float fDisc = fX * fSin - fY * fCos;
+
+			speeds[index] = ValidAngle(fA) && fDisc >= 0.0f ? fX * sqrtf(0.5f * fG / (fDisc * fCos)) : fNone;
+		}
+	}
+
+	/// @brief Finds the times several launches take to cover a horizontal distance
+	/// @param fX Horizontal distance
+	/// @param speeds Launch speeds
+	/// @param angles Launch angles
+	/// @param count Count of launches
+	/// @param times [out] Per launch, time, or fNone if the launch is invalid
+	/// @note This follows Trajectory.GetTime, with approximate sines
+	void GetTimes (float fX, float const * speeds, float const * angles, Uint count, float * times)
+	{
+		if (fX < 0.0f)
+		{
+			std::fill(times, times + count, fNone);
+
+			return;
+		}
+
+		Uint index = 0;
+
+#ifdef TRAJECTORY_SSE2
+		__m128 x = _mm_set1_ps(fX), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), none = _mm_set1_ps(fNone);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			__m128 v = _mm_loadu_ps(speeds + index), a = _mm_loadu_ps(angles + index);
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(v, zero), ValidAngle4(a));
+			__m128 s = Sin4(a), c = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(s, s)), zero));
+
+			_mm_storeu_ps(times + index, Select(valid, _mm_div_ps(x, _mm_mul_ps(v, c)), none));
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			float fV = speeds[index], fA = angles[index], fSin = Sin(fA);
+
+			times[index] = fV > 0.0f && ValidAngle(fA) ? fX / (fV * sqrtf(std::max(1.0f - fSin * fSin, 0.0f))) : fNone;
+		}
+	}
+
+	/// @brief Finds the velocities of several launches at a given time
+	/// @param begin Start of trajectories
+	/// @param end Point that sets the trajectories' heading
+	/// @param speeds Launch speeds
+	/// @param angles Launch angles
+	/// @param fG Gravity force
+	/// @param fT Time along trajectories
+	/// @param count Count of launches
+	/// @param x [out] Per launch, x-component of velocity, or fNone if the launch is invalid
+	/// @param y [out] Per launch, y-component, likewise
+	/// @param z [out] Per launch, z-component, likewise
+	/// @note This follows Trajectory.GetVelocity, with approximate sines
+	void GetVelocities (Vector const & begin, Vector const & end, float const * speeds, float const * angles, float fG, float fT, Uint count, float * x, float * y, float * z)
+	{
+		if (fG <= 0.0f || fT < 0.0f)
+		{
+			std::fill(x, x + count, fNone);
+			std::fill(y, y + count, fNone);
+			std::fill(z, z + count, fNone);
+
+			return;
+		}
+
+		Vector D = ~(end - begin).XZ();
+
+		Uint index = 0;
+
+#ifdef TRAJECTORY_SSE2
+		__m128 dx = _mm_set1_ps(D.m[0]), dz = _mm_set1_ps(D.m[2]), drop = _mm_set1_ps(fG * fT);
+		__m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), none = _mm_set1_ps(fNone);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			__m128 v = _mm_loadu_ps(speeds + index), a = _mm_loadu_ps(angles + index);
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(v, zero), ValidAngle4(a));
+			__m128 s = Sin4(a), c = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(s, s)), zero));
+
+			_mm_storeu_ps(x + index, Select(valid, _mm_mul_ps(_mm_mul_ps(dx, v), c), none));
+			_mm_storeu_ps(y + index, Select(valid, _mm_sub_ps(_mm_mul_ps(v, s), drop), none));
+			_mm_storeu_ps(z + index, Select(valid, _mm_mul_ps(_mm_mul_ps(dz, v), c), none));
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			float fV = speeds[index], fA = angles[index];
+
+			if (fV <= 0.0f || !ValidAngle(fA))
+			{
+				x[index] = y[index] = z[index] = fNone;
+
+				continue;
+			}
+
+			float fSin = Sin(fA), fCos = sqrtf(std::max(1.0f - fSin * fSin, 0.0f));
+
+			x[index] = D.m[0] * fV * fCos;
+			y[index] = fV * fSin - fG * fT;
+			z[index] = D.m[2] * fV * fCos;
+		}
+	}
+
+	/// @brief Finds the times at which several launches reach a given height
+	/// @param fY Height
+	/// @param speeds Launch speeds
+	/// @param angles Launch angles
+	/// @param fG Gravity force
+	/// @param count Count of launches
+	/// @param lo [out] Per launch, the lesser non-negative time, or the only one; fNone if
+	///           there is none
+	/// @param hi [out] Per launch, the greater time, if there are two; otherwise, fNone
+	/// @note This follows Trajectory.GetYTimes, with approximate sines
+	void GetYTimes (float fY, float const * speeds, float const * angles, float fG, Uint count, float * lo, float * hi)
+	{
+		if (fG <= 0.0f)
+		{
+			std::fill(lo, lo + count, fNone);
+			std::fill(hi, hi + count, fNone);
+
+			return;
+		}
+
+		Uint index = 0;
+
+#ifdef TRAJECTORY_SSE2
+		__m128 gy = _mm_set1_ps(2.0f * fG * fY), g = _mm_set1_ps(fG), zero = _mm_setzero_ps(), none = _mm_set1_ps(fNone);
+
+		for (; index + 4 <= count; index += 4)
+		{
+			__m128 v = _mm_loadu_ps(speeds + index), a = _mm_loadu_ps(angles + index);
+			__m128 b = _mm_mul_ps(v, Sin4(a)), term = _mm_sub_ps(_mm_mul_ps(b, b), gy);
+			__m128 valid = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(v, zero), ValidAngle4(a)), _mm_cmpge_ps(term, zero));
+
+			// The lesser time is non-negative when the ascent outpaces the root; the greater,
+			// when the root outpaces the descent.
+			__m128 root = _mm_sqrt_ps(_mm_max_ps(term, zero));
+			__m128 ok1 = _mm_and_ps(valid, _mm_cmpge_ps(b, root)), ok2 = _mm_and_ps(valid, _mm_cmpge_ps(_mm_add_ps(b, root), zero));
+			__m128 t1 = _mm_div_ps(_mm_sub_ps(b, root), g), t2 = _mm_div_ps(_mm_add_ps(b, root), g);
+
+			_mm_storeu_ps(lo + index, Select(ok1, t1, Select(ok2, t2, none)));
+			_mm_storeu_ps(hi + index, Select(ok1, t2, none));
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			float fV = speeds[index], fA = angles[index], fB = fV * Sin(fA), fTerm = fB * fB - 2.0f * fG * fY;
+
+			lo[index] = hi[index] = fNone;
+
+			if (fV <= 0.0f || !ValidAngle(fA) || fTerm < 0.0f) continue;
+
+			fTerm = sqrtf(fTerm);
+
+			if (fB >= fTerm) lo[index] = (fB - fTerm) / fG, hi[index] = (fB + fTerm) / fG;
+
+			else if (fB + fTerm >= 0.0f) lo[index] = (fB + fTerm) / fG;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "App.h"
+#include <limits>
+
+namespace Trajectory
+{
+	typedef Lua::Uint Uint;
+	typedef Lua::AppTypes::Vector Vector;
+
+	/// @brief Result given where there is no solution; it is a NaN, so it equals no result
+	const float fNone = std::numeric_limits<float>::quiet_NaN();
+
+	/// @brief Tests whether a result has no solution
+	/// @param fV Result
+	/// @return If true, the result is fNone
+	inline bool IsNone (float fV) { return fV != fV; }
+
+	float ASin (float fX);
+	float Sin (float fA);
+
+	void GetAngles (float fX, float fY, float const * speeds, float fG, Uint count, float * lo, float * hi);
+	void GetMaxHeights (float const * speeds, float const * angles, float fG, Uint count, float * heights);
+	void GetPositions (Vector const & begin, Vector const & end, float const * speeds, float const * angles, float fG, float fT, Uint count, float * x, float * y, float * z);
+	void GetSpeeds (float fX, float fY, float const * angles, float fG, Uint count, float * speeds);
+	void GetTimes (float fX, float const * speeds, float const * angles, Uint count, float * times);
+	void GetVelocities (Vector const & begin, Vector const & end, float const * speeds, float const * angles, float fG, float fT, Uint count, float * x, float * y, float * z);
+	void GetYTimes (float fY, float const * speeds, float const * angles, float fG, Uint count, float * lo, float * hi);
+}
+
+#endif // TRAJECTORY_H
\ No newline at end of file
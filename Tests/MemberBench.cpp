@@ -0,0 +1,254 @@
+// Times member access through the __index and __newindex made by Lua::MemberBindFuncs, on a
+// struct with 20 members, against the earlier scheme of a closure called per member, the same
+// data in a plain Lua table, and Get / Set methods.
+// Build from the root directory with Core/Lua_Utilities.cpp, Core/Lua_Help.cpp, and the
+// Lua library, e.g. g++ -O2 -ICore Tests/MemberBench.cpp Core/Lua_Utilities.cpp
+// Core/Lua_Help.cpp -llua, then run it without arguments.
+#include "../Core/App.h"
+#include <cstddef>
+#include <cstdio>
+#include <new>
+
+/// @brief Benchmark datum, with members of the common types
+struct Datum {
+	float mF0, mF1, mF2, mF3, mF4;
+	Sint32 mI0, mI1, mI2, mI3, mI4;
+	Uint8 mU0, mU1, mU2, mU3, mU4;
+	double mD0, mD1, mD2;
+	bool mB0, mB1;
+};
+
+/// @brief Iterations of each loop
+static const int Iterations = 2000000;
+
+/// @brief Benchmark loops; each reads ten members or writes five, per iteration
+/// @note Member access is through fields, except for the method version
+static char const Loops[] =
+	"local s, n, clock = ...;\n"
+	"local t, sum = clock(), 0;\n"
+	"for i = 1, n do\n"
+	"	sum = sum + s.f0 + s.f1 + s.i2 + s.i3 + s.u2 + s.d1 + s.d2 + s.u4 + s.f3 + s.i4;\n"
+	"end\n"
+	"local read = clock() - t;\n"
+	"t = clock();\n"
+	"for i = 1, n do\n"
+	"	s.f0 = i; s.i1 = i; s.d2 = i; s.u3 = 7; s.f2 = 1;\n"
+	"end\n"
+	"return read, clock() - t;\n";
+
+static char const MethodLoops[] =
+	"local s, n, clock = ...;\n"
+	"local t, sum = clock(), 0;\n"
+	"for i = 1, n do\n"
+	"	sum = sum + s:Getf0() + s:Getf1() + s:Geti2() + s:Geti3() + s:Getu2() + s:Getd1() + s:Getd2() + s:Getu4() + s:Getf3() + s:Geti4();\n"
+	"end\n"
+	"local read = clock() - t;\n"
+	"t = clock();\n"
+	"for i = 1, n do\n"
+	"	s:Setf0(i); s:Seti1(i); s:Setd2(i); s:Setu3(7); s:Setf2(1);\n"
+	"end\n"
+	"return read, clock() - t;\n";
+
+/// @brief Method accessors, as a binding without member closures would write them
+/// @note datum[, value]: Datum userdatum[, value to assign]
+template<typename T, size_t offset> static T & At (lua_State * L)
+{
+	return *reinterpret_cast<T*>(static_cast<Uint8*>(lua_touserdata(L, 1)) + offset);
+}
+
+template<typename T, size_t offset> static int Get (lua_State * L)
+{
+	lua_pushnumber(L, lua_Number(At<T, offset>(L)));
+
+	return 1;
+}
+
+template<typename T, size_t offset> static int Set (lua_State * L)
+{
+	At<T, offset>(L) = T(luaL_checknumber(L, 2));
+
+	return 0;
+}
+
+/// @brief Earlier member accessors: a closure per member, bound to its offset, called from
+///        __index or __newindex with the datum
+/// @note upvalue 1: Member offset
+template<typename T> static T & Field (lua_State * L, int index)
+{
+	return *reinterpret_cast<T*>(static_cast<Uint8*>(lua_touserdata(L, index)) + lua_tointeger(L, lua_upvalueindex(1)));
+}
+
+template<typename T> static int OldGet (lua_State * L)
+{
+	lua_pushnumber(L, lua_Number(Field<T>(L, 3)));
+
+	return 1;
+}
+
+template<typename T> static int OldSet (lua_State * L)
+{
+	Field<T>(L, 4) = T(luaL_checknumber(L, 3));
+
+	return 0;
+}
+
+/// @note upvalue 1: Getter table
+static int OldIndex (lua_State * L)
+{
+	lua_pushvalue(L, 2);// datum, key, key
+	lua_rawget(L, lua_upvalueindex(1));	// datum, key, getter
+
+	if (lua_isnil(L, 3)) return 1;
+
+	lua_insert(L, 1);	// getter, datum, key
+	lua_pushvalue(L, 2);// getter, datum, key, datum
+	lua_call(L, 3, 1);	// result
+
+	return 1;
+}
+
+/// @note upvalue 1: Setter table
+static int OldNewIndex (lua_State * L)
+{
+	lua_pushvalue(L, 2);// datum, key, value, key
+	lua_rawget(L, lua_upvalueindex(1));	// datum, key, value, setter
+
+	if (lua_isnil(L, 4)) return 0;
+
+	lua_insert(L, 1);	// setter, datum, key, value
+	lua_pushvalue(L, 2);// setter, datum, key, value, datum
+	lua_call(L, 4, 1);	// result
+
+	return 0;
+}
+
+/// @brief Adds an earlier-style getter and setter to their tables
+/// @param name Member name
+/// @param offset Member offset
+/// @note G, S: Getter and setter tables
+template<typename T> static void AddOld (lua_State * L, char const * name, size_t offset)
+{
+	lua_pushinteger(L, lua_Integer(offset));// G, S, offset
+	lua_pushcclosure(L, OldGet<T>, 1);	// G, S, getter
+	lua_setfield(L, -3, name);	// G = { ..., name = getter }, S
+	lua_pushinteger(L, lua_Integer(offset));// G, S, offset
+	lua_pushcclosure(L, OldSet<T>, 1);	// G, S, setter
+	lua_setfield(L, -2, name);	// G, S = { ..., name = setter }
+}
+
+#define A_(n, m, t) { "Get" #n, Get<t, offsetof(Datum, m)> }, { "Set" #n, Set<t, offsetof(Datum, m)> }
+
+static const luaL_Reg Methods[] = {
+	A_(f0, mF0, float), A_(f1, mF1, float), A_(f2, mF2, float), A_(f3, mF3, float),
+	A_(i1, mI1, Sint32), A_(i2, mI2, Sint32), A_(i3, mI3, Sint32), A_(i4, mI4, Sint32),
+	A_(u2, mU2, Uint8), A_(u3, mU3, Uint8), A_(u4, mU4, Uint8),
+	A_(d1, mD1, double), A_(d2, mD2, double),
+	{ 0, 0 }
+};
+
+#undef A_
+
+/// @brief Runs the loops over a value, and reports the times
+/// @param name Name of the access path
+/// @param loops Loops to run
+/// @note value: Value to access, which is popped
+static void Run (lua_State * L, char const * name, char const * loops)
+{
+	if (luaL_loadstring(L, loops) != 0) lua_error(L);	// value, loops
+
+	lua_insert(L, -2);	// loops, value
+	lua_pushinteger(L, Iterations);	// loops, value, n
+	lua_getglobal(L, "os");	// loops, value, n, os
+	lua_getfield(L, -1, "clock");	// loops, value, n, os, clock
+	lua_replace(L, -2);	// loops, value, n, clock
+	lua_call(L, 3, 2);	// read, write
+
+	printf("%-9s read %.3fs, write %.3fs\n", name, lua_tonumber(L, -2), lua_tonumber(L, -1));
+
+	lua_pop(L, 2);
+}
+
+int main (void)
+{
+	lua_State * L = luaL_newstate();
+
+	luaL_openlibs(L);
+
+	// Describe the members, one read-only, as a binding would.
+	Lua::Member_Reg members[20];
+
+	#define M_(i, n, m, t) members[i].Set(offsetof(Datum, m), #n, Lua::Member_Reg::t)
+
+	M_(0, f0, mF0, eFSingle), M_(1, f1, mF1, eFSingle), M_(2, f2, mF2, eFSingle), M_(3, f3, mF3, eFSingle), M_(4, f4, mF4, eFSingle);
+	M_(5, i0, mI0, eS32), M_(6, i1, mI1, eS32), M_(7, i2, mI2, eS32), M_(8, i3, mI3, eS32), M_(9, i4, mI4, eS32);
+	M_(10, u0, mU0, eU8), M_(11, u1, mU1, eU8), M_(12, u2, mU2, eU8), M_(13, u3, mU3, eU8), M_(14, u4, mU4, eU8);
+	M_(15, d0, mD0, eFDouble), M_(16, d1, mD1, eFDouble), M_(17, d2, mD2, eFDouble);
+	M_(18, b0, mB0, eBoolean), M_(19, b1, mB1, eBoolean);
+
+	#undef M_
+
+	members[4].mPermissions = Lua::Member_Reg::eRO;
+
+	// Member closures, over a datum in the userdatum's memory.
+	new (lua_newuserdata(L, sizeof(Datum))) Datum();// datum
+
+	lua_newtable(L);// datum, mt
+
+	Lua::MemberBindFuncs(L, 0, 0, members, 20, Lua::eThis);	// datum, mt, __index, __newindex
+
+	lua_setfield(L, -3, "__newindex");	// datum, mt = { __newindex }, __index
+	lua_setfield(L, -2, "__index");	// datum, mt = { __index, __newindex }
+	lua_setmetatable(L, -2);// datum
+
+	Run(L, "members", Loops);
+
+	// Earlier closure per member, for the numeric members the loops use.
+	new (lua_newuserdata(L, sizeof(Datum))) Datum();// datum
+
+	lua_newtable(L);// datum, mt
+	lua_newtable(L);// datum, mt, G
+	lua_newtable(L);// datum, mt, G, S
+
+	#define O_(n, m, t) AddOld<t>(L, #n, offsetof(Datum, m))
+
+	O_(f0, mF0, float), O_(f1, mF1, float), O_(f2, mF2, float), O_(f3, mF3, float);
+	O_(i1, mI1, Sint32), O_(i2, mI2, Sint32), O_(i3, mI3, Sint32), O_(i4, mI4, Sint32);
+	O_(u2, mU2, Uint8), O_(u3, mU3, Uint8), O_(u4, mU4, Uint8);
+	O_(d1, mD1, double), O_(d2, mD2, double);
+
+	#undef O_
+
+	lua_pushcclosure(L, OldNewIndex, 1);// datum, mt, G, __newindex
+	lua_setfield(L, -3, "__newindex");	// datum, mt = { __newindex }, G
+	lua_pushcclosure(L, OldIndex, 1);	// datum, mt, __index
+	lua_setfield(L, -2, "__index");	// datum, mt = { __index, __newindex }
+	lua_setmetatable(L, -2);// datum
+
+	Run(L, "closures", Loops);
+
+	// Plain table, as a lower bound.
+	lua_createtable(L, 0, 20);	// table
+
+	for (int index = 0; index < 20; ++index)
+	{
+		lua_pushnumber(L, 0);	// table, 0
+		lua_setfield(L, -2, members[index].mName.c_str());	// table = { ..., name = 0 }
+	}
+
+	Run(L, "table", Loops);
+
+	// Get / Set methods.
+	new (lua_newuserdata(L, sizeof(Datum))) Datum();// datum
+
+	lua_newtable(L);// datum, mt
+	lua_newtable(L);// datum, mt, methods
+	luaL_register(L, 0, Methods);
+	lua_setfield(L, -2, "__index");	// datum, mt = { __index = methods }
+	lua_setmetatable(L, -2);// datum
+
+	Run(L, "methods", MethodLoops);
+
+	lua_close(L);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "AABox.h"
+
+namespace Voxel
+{
+	/// @brief Constructs an AABox object
+	/// @param lo Lesser box corner, relative to space origin
+	/// @param hi Greater box corner, relative to space origin
+	/// @param dx Extent of space cell in x-direction
+	/// @param dy Extent of space cell in y-direction
+	/// @param dz Extent of space cell in z-direction
+	/// @param order Order used to obtain spans
+	AABox::AABox (float lo[3], float hi[3], float dx, float dy, float dz, Order order) : Convex<AABox>(dx, dy, dz, order)
+	{
+		if (lo[0] > hi[0] || lo[1] > hi[1] || lo[2] > hi[2]) throw "Inverted box";
+
+		float sL[3], sG[3];
+
+		Standard(lo, sL);
+		Standard(hi, sG);
+
+		mXL = sL[eTX];
+		mXG = sG[eTX];
+
+		Scan(sL, sG);
+	}
+
+	/// @brief Gets the x-extent of the box within a row
+	/// @param xL [out] Lesser x-value
+	/// @param xG [out] Greater x-value
+	/// @return If true, the row meets the box
+	/// @note Every row in the box bounds spans its full width, so the row bounds are unused
+	bool AABox::Extent (float, float, float, float, float & xL, float & xG)
+	{
+		xL = mXL;
+		xG = mXG;
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef VOXEL_AABOX_H
+#define VOXEL_AABOX_H
+
+#include "Voxel.h"
+#include "VoxelImp.h"
+#include "Convex.h"
+
+namespace Voxel
+{
+	/// @brief Axis-aligned box data
+	struct AABox : public Convex<AABox> {
+		// Members
+		float mXL;	///< Lesser x-value, in standard form
+		float mXG;	///< Greater x-value, in standard form
+
+		// Lifetime
+		AABox (float lo[3], float hi[3], float dx, float dy, float dz, Order order);
+
+		// Methods
+		bool Extent (float yL, float yG, float zL, float zG, float & xL, float & xG);
+	};
+}
+
+#endif // VOXEL_AABOX_H
\ No newline at end of file
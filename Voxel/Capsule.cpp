@@ -0,0 +1,169 @@
+#include "Capsule.h"
+
+namespace Voxel
+{
+	/// @brief Gets the distance from a value to an interval, as a linear function of t on a piece
+	/// @param p Value at t = 0
+	/// @param v Change in value per unit of t
+	/// @param t Parameter at which to choose the case, inside the piece
+	/// @param lo Lesser interval bound
+	/// @param hi Greater interval bound
+	/// @param e [out] Distance at t = 0
+	/// @param f [out] Change in distance per unit of t
+	static void Outside (float p, float v, float t, float lo, float hi, float & e, float & f)
+	{
+		float value = p + t * v;
+
+		if (value < lo) e = lo - p, f = -v;
+
+		else if (value > hi) e = p - hi, f = v;
+
+		else e = f = 0.0f;
+	}
+
+	/// @brief Gets the real roots of a quadratic
+	/// @param a Coefficient of t^2
+	/// @param b Coefficient of t
+	/// @param c Constant term
+	/// @param roots [out] Roots, in increasing order
+	/// @return Count of roots
+	/// @note A slightly negative discriminant is taken as 0, so a double root is not lost to round-off
+	static int Roots (float a, float b, float c, float roots[2])
+	{
+		if (a == 0.0f)
+		{
+			if (b == 0.0f) return 0;
+
+			roots[0] = -c / b;
+
+			return 1;
+		}
+
+		float disc = sqrtf(std::max(b * b - 4.0f * a * c, 0.0f));
+
+		roots[0] = (-b - disc) / (2.0f * a);
+		roots[1] = (-b + disc) / (2.0f * a);
+
+		if (roots[0] > roots[1]) std::swap(roots[0], roots[1]);
+
+		return 2;
+	}
+
+	/// @brief Constructs a Capsule object
+	/// @param p1 Segment start, relative to space origin
+	/// @param p2 Segment end, relative to space origin
+	/// @param radius Capsule radius
+	/// @param dx Extent of space cell in x-direction
+	/// @param dy Extent of space cell in y-direction
+	/// @param dz Extent of space cell in z-direction
+	/// @param order Order used to obtain spans
+	Capsule::Capsule (float p1[3], float p2[3], float radius, float dx, float dy, float dz, Order order) : Convex<Capsule>(dx, dy, dz, order), mR2(radius * radius)
+	{
+		if (radius <= 0.0f) throw "Non-positive radius";
+
+		float s1[3], s2[3], lo[3], hi[3];
+
+		Standard(p1, s1);
+		Standard(p2, s2);
+
+		for (int k = 0; k < 3; ++k)
+		{
+			mP[k] = s1[k];
+			mV[k] = s2[k] - s1[k];
+
+			lo[k] = std::min(s1[k], s2[k]) - radius;
+			hi[k] = std::max(s1[k], s2[k]) + radius;
+		}
+
+		Scan(lo, hi);
+	}
+
+	/// @brief Gets the x-extent of the capsule within a row
+	/// @param yL Lesser y-bound of row
+	/// @param yG Greater y-bound of row
+	/// @param zL Lesser z-bound of row
+	/// @param zG Greater z-bound of row
+	/// @param xL [out] Lesser x-value
+	/// @param xG [out] Greater x-value
+	/// @return If true, the row meets the capsule
+	/// @note The sphere at segment point t meets the row where h(t) = r^2 - d(t)^2 is non-negative,
+	///       d(t) being its distance from the row in the yz-plane, and spans x(t) -/+ sqrt(h(t)).
+	///       The segment is cut where it crosses the row's bounds; on each piece, h(t) is quadratic,
+	///       and the extrema lie where it starts or stops being non-negative, or where
+	///       h'(t)^2 = 4 x'(t)^2 h(t)
+	bool Capsule::Extent (float yL, float yG, float zL, float zG, float & xL, float & xG)
+	{
+		float cuts[6], bounds[4] = { yL, yG, zL, zG };
+		int n = 0;
+
+		cuts[n++] = 0.0f;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			float v = mV[i < 2 ? eTY : eTZ];
+
+			if (v == 0.0f) continue;
+
+			float t = (bounds[i] - mP[i < 2 ? eTY : eTZ]) / v;
+
+			if (t > 0.0f && t < 1.0f) cuts[n++] = t;
+		}
+
+		cuts[n++] = 1.0f;
+
+		std::sort(cuts, cuts + n);
+
+		// Gather the extrema over each piece.
+		bool bHit = false;
+
+		for (int i = 0; i + 1 < n; ++i)
+		{
+			float t1 = cuts[i], t2 = cuts[i + 1], ey, fy, ez, fz;
+
+			Outside(mP[eTY], mV[eTY], 0.5f * (t1 + t2), yL, yG, ey, fy);
+			Outside(mP[eTZ], mV[eTZ], 0.5f * (t1 + t2), zL, zG, ez, fz);
+
+			// Clip the piece to where h(t) = at^2 + bt + c is non-negative.
+			float a = -(fy * fy + fz * fz), b = -2.0f * (ey * fy + ez * fz), c = mR2 - ey * ey - ez * ez;
+			float roots[2];
+
+			if (a == 0.0f)
+			{
+				if (c < 0.0f) continue;
+			}
+
+			else
+			{
+				if (b * b - 4.0f * a * c < 0.0f) continue;
+
+				Roots(a, b, c, roots);
+
+				t1 = std::max(t1, roots[0]);
+				t2 = std::min(t2, roots[1]);
+
+				if (t1 > t2) continue;
+			}
+
+			// Check the ends, then any stationary points between them.
+			float ts[4] = { t1, t2 }, k = a - mV[eTX] * mV[eTX];
+			int count = 2 + Roots(a * k, b * k, 0.25f * b * b - mV[eTX] * mV[eTX] * c, roots);
+
+			ts[2] = roots[0];
+			ts[3] = roots[1];
+
+			for (int j = 0; j < count; ++j)
+			{
+				if (ts[j] < t1 || ts[j] > t2) continue;
+
+				float x = mP[eTX] + ts[j] * mV[eTX], s = sqrtf(std::max((a * ts[j] + b) * ts[j] + c, 0.0f));
+
+				xL = bHit ? std::min(xL, x - s) : x - s;
+				xG = bHit ? std::max(xG, x + s) : x + s;
+
+				bHit = true;
+			}
+		}
+
+		return bHit;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef VOXEL_CAPSULE_H
+#define VOXEL_CAPSULE_H
+
+#include "Voxel.h"
+#include "VoxelImp.h"
+#include "Convex.h"
+
+namespace Voxel
+{
+	/// @brief Capsule data, i.e. a sphere swept along a segment
+	struct Capsule : public Convex<Capsule> {
+		// Members
+		float mP[3];	///< Segment start, in standard form
+		float mV[3];	///< Segment vector, in standard form
+		float mR2;	///< Cached squared radius
+
+		// Lifetime
+		Capsule (float p1[3], float p2[3], float radius, float dx, float dy, float dz, Order order);
+
+		// Methods
+		bool Extent (float yL, float yG, float zL, float zG, float & xL, float & xG);
+	};
+}
+
+#endif // VOXEL_CAPSULE_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef VOXEL_CONVEX_H
+#define VOXEL_CONVEX_H
+
+#include "Voxel.h"
+#include "VoxelImp.h"
+#include "Packed.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Voxel
+{
+	/// @brief Convex shape, scanned row by row in standard form
+	/// @note S supplies Extent (yL, yG, zL, zG, xL, xG), which gets the x-extent of the part of
+	///       the shape within a row's y- and z-bounds, returning false if the row misses it
+	template<typename S> struct Convex : public Packed {
+		// Members
+		int mAxes[3];	///< Axes of columns, rows, and spans
+
+		// Lifetime
+		Convex (float dx, float dy, float dz, Order order);
+
+		// Methods
+		void Scan (float lo[3], float hi[3]);
+		void Standard (float const v[3], float out[3]) const;
+	};
+
+	/// @brief Constructs a Convex object
+	/// @param dx Extent of space cell in x-direction
+	/// @param dy Extent of space cell in y-direction
+	/// @param dz Extent of space cell in z-direction
+	/// @param order Order used to obtain spans
+	template<typename S> inline Convex<S>::Convex (float dx, float dy, float dz, Order order) : Packed(dx, dy, dz)
+	{
+		GetAxes(order, mAxes);
+
+		float d[3];
+
+		Standard(mD, d);
+
+		std::copy(d, d + 3, mD);
+	}
+
+	/// @brief Adds a span for each row the shape passes through, then packs them
+	/// @param lo Lesser corner of shape bounds, in standard form
+	/// @param hi Greater corner of shape bounds, in standard form
+	template<typename S> inline void Convex<S>::Scan (float lo[3], float hi[3])
+	{
+		Cell cMin(lo, mD[eTX], mD[eTY], mD[eTZ], 0.0f);
+		Cell cMax(hi, mD[eTX], mD[eTY], mD[eTZ], 0.0f);
+
+		for (int cY = cMin.m[eTY]; cY <= cMax.m[eTY]; ++cY)
+		{
+			float yL = (cY - 0.5f) * mD[eTY], yG = yL + mD[eTY];
+
+			for (int cZ = cMin.m[eTZ]; cZ <= cMax.m[eTZ]; ++cZ)
+			{
+				float zL = (cZ - 0.5f) * mD[eTZ], zG = zL + mD[eTZ], xL, xG;
+
+				if (!static_cast<S*>(this)->Extent(yL, yG, zL, zG, xL, xG)) continue;
+
+				// Keep round-off from pushing the span out of bounds.
+				int cx1 = int(ceilf(xL / mD[eTX] - 0.5f));
+				int cx2 = int(ceilf(xG / mD[eTX] - 0.5f));
+
+				AddEntry(std::max(cx1, cMin.m[eTX]), std::min(cx2, cMax.m[eTX]), cY, cZ);
+			}
+		}
+
+		// The rows were added column by column, so they pack in place.
+		Pack(cMin.m[eTY], cMax.m[eTY], mSpans.size());
+	}
+
+	/// @brief Converts a vector to the standard form of the ordering
+	/// @param v Vector to convert, relative to the x, y, z axes
+	/// @param out [out] Converted vector
+	template<typename S> inline void Convex<S>::Standard (float const v[3], float out[3]) const
+	{
+		out[eTX] = v[mAxes[2]];
+		out[eTY] = v[mAxes[0]];
+		out[eTZ] = v[mAxes[1]];
+	}
+}
+
+#endif // VOXEL_CONVEX_H
\ No newline at end of file
@@ -0,0 +1,476 @@
+#include "Grid.h"
+#include <algorithm>
+
+namespace Voxel
+{
+	/// @brief Gets the brick that holds a cell
+	/// @param c Cell coordinate
+	/// @return Brick coordinate
+	static inline int ToBrick (int c)
+	{
+		return c >= 0 ? c / 8 : -((7 - c) / 8);
+	}
+
+	/// @brief Locates a cell's bit within its brick
+	/// @param x, y, z Cell coordinates
+	/// @param word [out] Index of word holding the bit
+	/// @return Bit's shift within the word
+	static inline int Locate (int x, int y, int z, int & word)
+	{
+		int index = ((y & 7) << 3) | (z & 7);
+
+		word = index >> 2;
+
+		return ((index & 3) << 3) | (x & 7);
+	}
+
+	/// @brief Counts the bits set in a word
+	/// @param bits Word to count
+	/// @return Bit count
+	static inline std::size_t CountBits (Word bits)
+	{
+		bits = bits - ((bits >> 1) & 0x55555555U);
+		bits = (bits & 0x33333333U) + ((bits >> 2) & 0x33333333U);
+
+		return (((bits + (bits >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+	}
+
+	/// @brief Orders entries by column, then row, then initial cell
+	/// @param e1 Entry to compare
+	/// @param e2 Entry to compare
+	/// @return If true, e1 comes first
+	static bool Before (Entry const & e1, Entry const & e2)
+	{
+		if (e1.mY != e2.mY) return e1.mY < e2.mY;
+		if (e1.mZ != e2.mZ) return e1.mZ < e2.mZ;
+
+		return e1.mX1 < e2.mX1;
+	}
+
+	/// @brief Constructs a Grid object
+	/// @param dx Extent of space cell in x-direction
+	/// @param dy Extent of space cell in y-direction
+	/// @param dz Extent of space cell in z-direction
+	Grid::Grid (float dx, float dy, float dz)
+	{
+		if (dx <= 0.0f) throw "Non-positive dx";
+		if (dy <= 0.0f) throw "Non-positive dy";
+		if (dz <= 0.0f) throw "Non-positive dz";
+
+		mD[eTX] = dx;
+		mD[eTY] = dy;
+		mD[eTZ] = dz;
+	}
+
+	/// @brief Clears all cells
+	/// @note Storage is kept for reuse
+	void Grid::Clear (void)
+	{
+		mBricks.clear();
+
+		std::fill(mTable.begin(), mTable.end(), 0U);
+	}
+
+	/// @brief Clears a span of cells
+	/// @param order Ordering of the span's coordinates
+	/// @param c Column cell
+	/// @param r Row cell
+	/// @param s1 Initial span cell
+	/// @param s2 Final span cell
+	void Grid::Erase (Order order, int c, int r, int s1, int s2)
+	{
+		Span(order, c, r, s1, s2, false);
+	}
+
+	/// @brief Sets a span of cells
+	/// @param order Ordering of the span's coordinates
+	/// @param c Column cell
+	/// @param r Row cell
+	/// @param s1 Initial span cell
+	/// @param s2 Final span cell
+	void Grid::Fill (Order order, int c, int r, int s1, int s2)
+	{
+		Span(order, c, r, s1, s2, true);
+	}
+
+	/// @brief Keeps only the cells also set in another grid
+	/// @param grid Grid to intersect
+	/// @note The grids must have the same cell dimensions
+	void Grid::Intersect (Grid const & grid)
+	{
+		Match(grid);
+
+		for (std::size_t i = 0; i < mBricks.size(); ++i)
+		{
+			Brick & brick = mBricks[i];
+
+			Brick const * other = grid.Find(brick.mX, brick.mY, brick.mZ);
+
+			for (int w = 0; w < 16; ++w) brick.mBits[w] &= other ? other->mBits[w] : 0U;
+		}
+	}
+
+	/// @brief Clears the cells set in another grid
+	/// @param grid Grid to subtract
+	/// @note The grids must have the same cell dimensions
+	void Grid::Subtract (Grid const & grid)
+	{
+		Match(grid);
+
+		for (std::size_t i = 0; i < grid.mBricks.size(); ++i)
+		{
+			Brick const & brick = grid.mBricks[i];
+
+			Brick * mine = Find(brick.mX, brick.mY, brick.mZ);
+
+			if (mine) for (int w = 0; w < 16; ++w) mine->mBits[w] &= ~brick.mBits[w];
+		}
+	}
+
+	/// @brief Sets the cells set in another grid
+	/// @param grid Grid to unite
+	/// @note The grids must have the same cell dimensions
+	void Grid::Union (Grid const & grid)
+	{
+		Match(grid);
+
+		for (std::size_t i = 0; i < grid.mBricks.size(); ++i)
+		{
+			// Copy the bits first, since adding a brick may move the other grid's bricks
+			// when both grids are the same.
+			Brick brick = grid.mBricks[i];
+
+			Word any = 0;
+
+			for (int w = 0; w < 16; ++w) any |= brick.mBits[w];
+
+			if (!any) continue;
+
+			Brick & mine = Obtain(brick.mX, brick.mY, brick.mZ);
+
+			for (int w = 0; w < 16; ++w) mine.mBits[w] |= brick.mBits[w];
+		}
+	}
+
+	/// @brief Gets whether a cell is set
+	/// @param x, y, z Cell coordinates
+	/// @return If true, the cell is set
+	bool Grid::Get (int x, int y, int z) const
+	{
+		Brick const * brick = Find(ToBrick(x), ToBrick(y), ToBrick(z));
+
+		if (!brick) return false;
+
+		int word, shift = Locate(x, y, z, word);
+
+		return (brick->mBits[word] >> shift) & 1U;
+	}
+
+	/// @brief Tests whether any cell in a span is set
+	/// @param order Ordering of the span's coordinates
+	/// @param c Column cell
+	/// @param r Row cell
+	/// @param s1 Initial span cell
+	/// @param s2 Final span cell
+	/// @return If true, some cell is set
+	bool Grid::Test (Order order, int c, int r, int s1, int s2) const
+	{
+		if (s1 > s2) std::swap(s1, s2);
+
+		int axes[3], p[3];
+
+		GetAxes(order, axes);
+
+		p[axes[0]] = c;
+		p[axes[1]] = r;
+
+		// Test spans along x a brick's worth at a time; step along others cell by cell.
+		if (eTX == axes[2])
+		{
+			for (int bx = ToBrick(s1); bx <= ToBrick(s2); ++bx)
+			{
+				Brick const * brick = Find(bx, ToBrick(p[eTY]), ToBrick(p[eTZ]));
+
+				if (!brick) continue;
+
+				int lo = std::max(s1, bx * 8) - bx * 8, hi = std::min(s2, bx * 8 + 7) - bx * 8;
+				int word, shift = Locate(lo, p[eTY], p[eTZ], word);
+
+				if (brick->mBits[word] & (((2U << (hi - lo)) - 1U) << shift)) return true;
+			}
+		}
+
+		else
+		{
+			for (int s = s1; s <= s2; ++s)
+			{
+				p[axes[2]] = s;
+
+				if (Get(p[eTX], p[eTY], p[eTZ])) return true;
+			}
+		}
+
+		return false;
+	}
+
+	/// @brief Gets the count of allocated bricks
+	/// @return Brick count
+	/// @note Bricks cleared by erasure or intersection stay allocated until the grid is cleared
+	std::size_t Grid::GetBrickCount (void) const
+	{
+		return mBricks.size();
+	}
+
+	/// @brief Gets the count of set cells
+	/// @return Cell count
+	std::size_t Grid::GetCount (void) const
+	{
+		std::size_t count = 0;
+
+		for (std::size_t i = 0; i < mBricks.size(); ++i)
+		{
+			for (int w = 0; w < 16; ++w) count += CountBits(mBricks[i].mBits[w]);
+		}
+
+		return count;
+	}
+
+	/// @brief Finds a brick
+	/// @param bx, by, bz Brick coordinates
+	/// @return Brick; 0 if absent
+	Grid::Brick * Grid::Find (int bx, int by, int bz)
+	{
+		return const_cast<Brick*>(static_cast<Grid const *>(this)->Find(bx, by, bz));
+	}
+
+	/// @brief Finds a brick
+	/// @param bx, by, bz Brick coordinates
+	/// @return Brick; 0 if absent
+	Grid::Brick const * Grid::Find (int bx, int by, int bz) const
+	{
+		if (mTable.empty()) return 0;
+
+		unsigned mask = unsigned(mTable.size() - 1);
+
+		for (unsigned slot = Hash(bx, by, bz) & mask; mTable[slot] != 0; slot = (slot + 1) & mask)
+		{
+			Brick const & brick = mBricks[mTable[slot] - 1];
+
+			if (brick.mX == bx && brick.mY == by && brick.mZ == bz) return &brick;
+		}
+
+		return 0;
+	}
+
+	/// @brief Gets a brick, adding it if absent
+	/// @param bx, by, bz Brick coordinates
+	/// @return Brick
+	Grid::Brick & Grid::Obtain (int bx, int by, int bz)
+	{
+		Brick * found = Find(bx, by, bz);
+
+		if (found) return *found;
+
+		// Keep the table at most half full.
+		if (2 * (mBricks.size() + 1) > mTable.size()) Rehash(std::max<std::size_t>(64, 2 * mTable.size()));
+
+		Brick brick;
+
+		brick.mX = bx;
+		brick.mY = by;
+		brick.mZ = bz;
+
+		std::fill(brick.mBits, brick.mBits + 16, 0U);
+
+		mBricks.push_back(brick);
+
+		unsigned mask = unsigned(mTable.size() - 1), slot = Hash(bx, by, bz) & mask;
+
+		while (mTable[slot] != 0) slot = (slot + 1) & mask;
+
+		mTable[slot] = unsigned(mBricks.size());
+
+		return mBricks.back();
+	}
+
+	/// @brief Checks that another grid has the same cell dimensions
+	/// @param grid Grid to check
+	void Grid::Match (Grid const & grid) const
+	{
+		if (mD[eTX] != grid.mD[eTX] || mD[eTY] != grid.mD[eTY] || mD[eTZ] != grid.mD[eTZ]) throw "Mismatched cell dimensions";
+	}
+
+	/// @brief Rebuilds the hash table
+	/// @param size Table size, a power of 2
+	void Grid::Rehash (std::size_t size)
+	{
+		mTable.assign(size, 0U);
+
+		unsigned mask = unsigned(size - 1);
+
+		for (std::size_t i = 0; i < mBricks.size(); ++i)
+		{
+			unsigned slot = Hash(mBricks[i].mX, mBricks[i].mY, mBricks[i].mZ) & mask;
+
+			while (mTable[slot] != 0) slot = (slot + 1) & mask;
+
+			mTable[slot] = unsigned(i + 1);
+		}
+	}
+
+	/// @brief Sets or clears a span of cells
+	/// @param order Ordering of the span's coordinates
+	/// @param c Column cell
+	/// @param r Row cell
+	/// @param s1 Initial span cell
+	/// @param s2 Final span cell
+	/// @param bFill If true, set the cells; otherwise, clear them
+	void Grid::Span (Order order, int c, int r, int s1, int s2, bool bFill)
+	{
+		if (s1 > s2) std::swap(s1, s2);
+
+		int axes[3], p[3];
+
+		GetAxes(order, axes);
+
+		p[axes[0]] = c;
+		p[axes[1]] = r;
+
+		// Spans along x cover a run of bits in one word per brick. Others step across rows,
+		// so are set cell by cell.
+		if (eTX == axes[2])
+		{
+			int by = ToBrick(p[eTY]), bz = ToBrick(p[eTZ]);
+
+			for (int bx = ToBrick(s1); bx <= ToBrick(s2); ++bx)
+			{
+				int lo = std::max(s1, bx * 8) - bx * 8, hi = std::min(s2, bx * 8 + 7) - bx * 8;
+				int word, shift = Locate(lo, p[eTY], p[eTZ], word);
+
+				Word mask = ((2U << (hi - lo)) - 1U) << shift;
+
+				if (bFill) Obtain(bx, by, bz).mBits[word] |= mask;
+
+				else
+				{
+					Brick * brick = Find(bx, by, bz);
+
+					if (brick) brick->mBits[word] &= ~mask;
+				}
+			}
+		}
+
+		else
+		{
+			for (int s = s1; s <= s2; ++s)
+			{
+				p[axes[2]] = s;
+
+				int word, shift = Locate(p[eTX], p[eTY], p[eTZ], word);
+
+				if (bFill) Obtain(ToBrick(p[eTX]), ToBrick(p[eTY]), ToBrick(p[eTZ])).mBits[word] |= 1U << shift;
+
+				else
+				{
+					Brick * brick = Find(ToBrick(p[eTX]), ToBrick(p[eTY]), ToBrick(p[eTZ]));
+
+					if (brick) brick->mBits[word] &= ~(1U << shift);
+				}
+			}
+		}
+	}
+
+	/// @brief Hashes a brick
+	/// @param bx, by, bz Brick coordinates
+	/// @return Hash value
+	unsigned Grid::Hash (int bx, int by, int bz)
+	{
+		return (unsigned(bx) * 73856093U) ^ (unsigned(by) * 19349663U) ^ (unsigned(bz) * 83492791U);
+	}
+
+	/// @brief Constructs a GridSpans object
+	/// @param grid Grid whose occupied cells are gathered into spans
+	/// @param order Order used to obtain spans
+	GridSpans::GridSpans (Grid const & grid, Order order) : Packed(1.0f, 1.0f, 1.0f)
+	{
+		int axes[3];
+
+		GetAxes(order, axes);
+
+		// Put the cell dimensions in standard form.
+		mD[eTX] = grid.mD[axes[2]];
+		mD[eTY] = grid.mD[axes[0]];
+		mD[eTZ] = grid.mD[axes[1]];
+
+		// Gather each brick's runs, line by line along the span axis.
+		for (std::size_t i = 0; i < grid.mBricks.size(); ++i)
+		{
+			Grid::Brick const & brick = grid.mBricks[i];
+
+			int base[3] = { brick.mX * 8, brick.mY * 8, brick.mZ * 8 }, p[3];
+
+			for (p[axes[0]] = 0; p[axes[0]] < 8; ++p[axes[0]])
+			{
+				for (p[axes[1]] = 0; p[axes[1]] < 8; ++p[axes[1]])
+				{
+					unsigned line = 0;
+
+					for (p[axes[2]] = 0; p[axes[2]] < 8; ++p[axes[2]])
+					{
+						int word, shift = Locate(p[eTX], p[eTY], p[eTZ], word);
+
+						line |= ((brick.mBits[word] >> shift) & 1U) << p[axes[2]];
+					}
+
+					for (int lo = 0; line != 0; )
+					{
+						while (!(line & (1U << lo))) ++lo;
+
+						int hi = lo;
+
+						while (hi < 7 && (line & (2U << hi))) ++hi;
+
+						Entry entry;
+
+						entry.mX1 = base[axes[2]] + lo;
+						entry.mX2 = base[axes[2]] + hi;
+						entry.mY = base[axes[0]] + p[axes[0]];
+						entry.mZ = base[axes[1]] + p[axes[1]];
+
+						mSpans.push_back(entry);
+
+						line &= ~((2U << hi) - (1U << lo));
+					}
+				}
+			}
+		}
+
+		// Sort the runs and join those that continue across bricks.
+		std::sort(mSpans.begin(), mSpans.end(), Before);
+
+		std::size_t count = 0;
+
+		for (std::size_t i = 0; i < mSpans.size(); ++i)
+		{
+			Entry & entry = mSpans[i];
+
+			if (count > 0)
+			{
+				Entry & last = mSpans[count - 1];
+
+				if (last.mY == entry.mY && last.mZ == entry.mZ && last.mX2 + 1 == entry.mX1)
+				{
+					last.mX2 = entry.mX2;
+
+					continue;
+				}
+			}
+
+			mSpans[count++] = entry;
+		}
+
+		mSpans.resize(count);
+
+		if (count > 0) Pack(mSpans.front().mY, mSpans.back().mY, count);
+	}
+}
\ No newline at end of file
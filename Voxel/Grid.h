@@ -0,0 +1,125 @@
+#ifndef VOXEL_GRID_H
+#define VOXEL_GRID_H
+
+#include "Voxel.h"
+#include "VoxelImp.h"
+#include "Packed.h"
+
+namespace Voxel
+{
+	typedef unsigned int Word;	///< Brick bit word
+
+	/// @brief Occupancy of a volume, kept in sparse 8 x 8 x 8 bricks
+	/// @note Cells are given in x, y, z order. In each brick, every (y, z) pair has a byte of
+	///       x-bits, four to a word, so spans along x are filled a word at a time
+	class Grid {
+	public:
+		/// @brief Brick of cells
+		struct Brick {
+			// Members
+			int mX;	///< x-coordinate, in bricks
+			int mY;	///< y-coordinate, in bricks
+			int mZ;	///< z-coordinate, in bricks
+			Word mBits[16];	///< Occupancy bits
+		};
+
+		enum {
+			eSpanChunk = 256	///< Count of spans read from a shape at once
+		};
+	private:
+		// Members
+		std::vector<Brick> mBricks;	///< Allocated bricks
+		std::vector<unsigned> mTable;	///< Hash table of bricks, as index + 1; 0 if empty
+		float mD[3];///< Cell dimensions
+
+		// Methods
+		Brick * Find (int bx, int by, int bz);
+		Brick const * Find (int bx, int by, int bz) const;
+		Brick & Obtain (int bx, int by, int bz);
+
+		void Match (Grid const & grid) const;
+		void Rehash (std::size_t size);
+		void Span (Order order, int c, int r, int s1, int s2, bool bFill);
+
+		static unsigned Hash (int bx, int by, int bz);
+
+		// Friendship
+		friend struct GridSpans;
+	public:
+		// Lifetime
+		Grid (float dx, float dy, float dz);
+
+		// Methods
+		void Clear (void);
+		void Erase (Order order, int c, int r, int s1, int s2);
+		void Fill (Order order, int c, int r, int s1, int s2);
+		void Intersect (Grid const & grid);
+		void Subtract (Grid const & grid);
+		void Union (Grid const & grid);
+
+		bool Get (int x, int y, int z) const;
+		bool Test (Order order, int c, int r, int s1, int s2) const;
+
+		float GetD (int axis) const { return mD[axis]; }
+
+		std::size_t GetBrickCount (void) const;
+		std::size_t GetCount (void) const;
+
+		template<typename S> void Erase (S & shape, Order order);
+		template<typename S> void Fill (S & shape, Order order);
+		template<typename S> bool Test (S & shape, Order order) const;
+	};
+
+	/// @brief Spans of a grid's occupied cells, in a given ordering
+	struct GridSpans : public Packed {
+		// Lifetime
+		GridSpans (Grid const & grid, Order order);
+	};
+
+	/// @brief Clears a shape's cells
+	/// @param shape Shape whose spans are cleared
+	/// @param order Order in which the shape gives its spans
+	template<typename S> inline void Grid::Erase (S & shape, Order order)
+	{
+		int spans[4 * eSpanChunk];
+
+		for (std::size_t first = 0, count; (count = shape.GetSpans(spans, first, eSpanChunk)) != 0; first += count)
+		{
+			for (std::size_t i = 0; i < 4 * count; i += 4) Span(order, spans[i], spans[i + 1], spans[i + 2], spans[i + 3], false);
+		}
+	}
+
+	/// @brief Sets a shape's cells
+	/// @param shape Shape whose spans are set
+	/// @param order Order in which the shape gives its spans
+	template<typename S> inline void Grid::Fill (S & shape, Order order)
+	{
+		int spans[4 * eSpanChunk];
+
+		for (std::size_t first = 0, count; (count = shape.GetSpans(spans, first, eSpanChunk)) != 0; first += count)
+		{
+			for (std::size_t i = 0; i < 4 * count; i += 4) Span(order, spans[i], spans[i + 1], spans[i + 2], spans[i + 3], true);
+		}
+	}
+
+	/// @brief Tests whether any of a shape's cells are set
+	/// @param shape Shape whose spans are tested
+	/// @param order Order in which the shape gives its spans
+	/// @return If true, some cell is set
+	template<typename S> inline bool Grid::Test (S & shape, Order order) const
+	{
+		int spans[4 * eSpanChunk];
+
+		for (std::size_t first = 0, count; (count = shape.GetSpans(spans, first, eSpanChunk)) != 0; first += count)
+		{
+			for (std::size_t i = 0; i < 4 * count; i += 4)
+			{
+				if (Test(order, spans[i], spans[i + 1], spans[i + 2], spans[i + 3])) return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+#endif // VOXEL_GRID_H
\ No newline at end of file
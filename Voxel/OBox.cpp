@@ -0,0 +1,145 @@
+#include "OBox.h"
+
+namespace Voxel
+{
+	/// @brief Corners of each box face, in order around it
+	static const int sFaces[6][4] = { { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 5, 7, 6 } };
+
+	/// @brief Clips a convex polygon against one side of an axis plane
+	/// @param in Polygon vertices
+	/// @param count Vertex count
+	/// @param out [out] Clipped polygon vertices
+	/// @param index Coordinate index of plane
+	/// @param bound Coordinate of plane
+	/// @param sense If +1, keep the side at or above the plane; if -1, at or below
+	/// @return Count of clipped polygon vertices
+	static int Clip (float in[][3], int count, float out[][3], int index, float bound, float sense)
+	{
+		int n = 0;
+
+		for (int i = 0, j = count - 1; i < count; j = i++)
+		{
+			float dI = sense * (in[i][index] - bound);
+			float dJ = sense * (in[j][index] - bound);
+
+			// Add the crossing point of any edge that passes through the plane.
+			if ((dI >= 0.0f) != (dJ >= 0.0f))
+			{
+				float t = dJ / (dJ - dI);
+
+				for (int k = 0; k < 3; ++k) out[n][k] = in[j][k] + t * (in[i][k] - in[j][k]);
+
+				++n;
+			}
+
+			if (dI >= 0.0f) std::copy(in[i], in[i] + 3, out[n++]);
+		}
+
+		return n;
+	}
+
+	/// @brief Constructs an OBox object
+	/// @param center Box center, relative to space origin
+	/// @param axes Box half-axes, i.e. its edge directions scaled by half their lengths
+	/// @param dx Extent of space cell in x-direction
+	/// @param dy Extent of space cell in y-direction
+	/// @param dz Extent of space cell in z-direction
+	/// @param order Order used to obtain spans
+	OBox::OBox (float center[3], float axes[3][3], float dx, float dy, float dz, Order order) : Convex<OBox>(dx, dy, dz, order)
+	{
+		Build(center, axes);
+	}
+
+	/// @brief Constructs an OBox object, to be built by a derived shape
+	/// @param dx Extent of space cell in x-direction
+	/// @param dy Extent of space cell in y-direction
+	/// @param dz Extent of space cell in z-direction
+	/// @param order Order used to obtain spans
+	OBox::OBox (float dx, float dy, float dz, Order order) : Convex<OBox>(dx, dy, dz, order)
+	{
+	}
+
+	/// @brief Finds the box corners and scans the box
+	/// @param center Box center, relative to space origin
+	/// @param axes Box half-axes
+	void OBox::Build (float center[3], float axes[3][3])
+	{
+		float lo[3], hi[3];
+
+		for (int i = 0; i < 8; ++i)
+		{
+			float corner[3];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				corner[k] = center[k];
+
+				for (int axis = 0; axis < 3; ++axis) corner[k] += (i & (1 << axis)) ? axes[axis][k] : -axes[axis][k];
+			}
+
+			Standard(corner, mCorners[i]);
+
+			for (int k = 0; k < 3; ++k)
+			{
+				lo[k] = i ? std::min(lo[k], mCorners[i][k]) : mCorners[i][k];
+				hi[k] = i ? std::max(hi[k], mCorners[i][k]) : mCorners[i][k];
+			}
+		}
+
+		// Bound each face, so rows can skip those they miss.
+		for (int face = 0; face < 6; ++face)
+		{
+			float * bounds = mFaces[face];
+
+			for (int i = 0; i < 4; ++i)
+			{
+				float const * corner = mCorners[sFaces[face][i]];
+
+				bounds[0] = i ? std::min(bounds[0], corner[eTY]) : corner[eTY];
+				bounds[1] = i ? std::max(bounds[1], corner[eTY]) : corner[eTY];
+				bounds[2] = i ? std::min(bounds[2], corner[eTZ]) : corner[eTZ];
+				bounds[3] = i ? std::max(bounds[3], corner[eTZ]) : corner[eTZ];
+			}
+		}
+
+		Scan(lo, hi);
+	}
+
+	/// @brief Gets the x-extent of the box within a row
+	/// @param yL Lesser y-bound of row
+	/// @param yG Greater y-bound of row
+	/// @param zL Lesser z-bound of row
+	/// @param zG Greater z-bound of row
+	/// @param xL [out] Lesser x-value
+	/// @param xG [out] Greater x-value
+	/// @return If true, the row meets the box
+	/// @note Every vertex of the part of the box within the row lies on some face, so each face
+	///       is clipped to the row and the extent is taken over what remains
+	bool OBox::Extent (float yL, float yG, float zL, float zG, float & xL, float & xG)
+	{
+		bool bHit = false;
+
+		for (int face = 0; face < 6; ++face)
+		{
+			if (mFaces[face][0] > yG || mFaces[face][1] < yL || mFaces[face][2] > zG || mFaces[face][3] < zL) continue;
+
+			float a[8][3], b[8][3];
+
+			for (int i = 0; i < 4; ++i) std::copy(mCorners[sFaces[face][i]], mCorners[sFaces[face][i]] + 3, a[i]);
+
+			int count = Clip(a, 4, b, eTY, yL, +1.0f);
+
+			count = Clip(b, count, a, eTY, yG, -1.0f);
+			count = Clip(a, count, b, eTZ, zL, +1.0f);
+			count = Clip(b, count, a, eTZ, zG, -1.0f);
+
+			for (int i = 0; i < count; ++i, bHit = true)
+			{
+				xL = bHit ? std::min(xL, a[i][eTX]) : a[i][eTX];
+				xG = bHit ? std::max(xG, a[i][eTX]) : a[i][eTX];
+			}
+		}
+
+		return bHit;
+	}
+}
\ No newline at end of file
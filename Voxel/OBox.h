@@ -0,0 +1,27 @@
+#ifndef VOXEL_OBOX_H
+#define VOXEL_OBOX_H
+
+#include "Voxel.h"
+#include "VoxelImp.h"
+#include "Convex.h"
+
+namespace Voxel
+{
+	/// @brief Oriented box data
+	/// @note The box may be any parallelepiped, including a flat one
+	struct OBox : public Convex<OBox> {
+		// Members
+		float mCorners[8][3];	///< Box corners, in standard form; bit i of the index picks the side of half-axis i
+		float mFaces[6][4];	///< Per face, y- and z-bounds, as yL, yG, zL, zG
+
+		// Lifetime
+		OBox (float center[3], float axes[3][3], float dx, float dy, float dz, Order order);
+		OBox (float dx, float dy, float dz, Order order);
+
+		// Methods
+		bool Extent (float yL, float yG, float zL, float zG, float & xL, float & xG);
+		void Build (float center[3], float axes[3][3]);
+	};
+}
+
+#endif // VOXEL_OBOX_H
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "Packed.h"
+#include <algorithm>
+
+namespace Voxel
+{
+	/// @brief Adds an entry, to be packed into its column
+	/// @param x1 x-cell of span start
+	/// @param x2 x-cell of span end
+	/// @param y y-cell of row
+	/// @param z z-cell of span
+	void Packed::AddEntry (int x1, int x2, int y, int z)
+	{
+		Entry entry;
+
+		entry.mX1 = x1;
+		entry.mX2 = x2;
+		entry.mY = y;
+		entry.mZ = z;
+
+		mSpans.push_back(entry);
+	}
+
+	/// @brief Gets the count of spans in the packed data
+	/// @return Span count
+	std::size_t Packed::GetSpanCount (void)
+	{
+		return mSpans.size();
+	}
+
+	/// @brief Writes a run of spans into a buffer, in forward order
+	/// @param spans [out] Buffer that receives the spans, as (column, row, initial, final) cells
+	/// @param first Index of first span to write
+	/// @param count Greatest count of spans to write
+	/// @return Count of spans written; if 0, the spans are exhausted
+	/// @note The spans are packed in forward order, so the run is copied directly
+	std::size_t Packed::GetSpans (int * spans, std::size_t first, std::size_t count)
+	{
+		if (first >= mSpans.size()) return 0;
+
+		count = std::min(count, mSpans.size() - first);
+
+		for (std::size_t i = 0; i < count; ++i, spans += 4)
+		{
+			Entry const & entry = mSpans[first + i];
+
+			spans[0] = entry.mY;
+			spans[1] = entry.mZ;
+			spans[2] = entry.mX1;
+			spans[3] = entry.mX2;
+		}
+
+		return count;
+	}
+
+	/// @brief Packs the entries, in the order added, into columns
+	/// @param first First column cell
+	/// @param last Last column cell
+	/// @param front Index of the first entry to go to the front of its column
+	/// @note Entries added before the front index go to the back of their columns, in order;
+	///       those added after go to the front, in reverse order
+	void Packed::Pack (int first, int last, std::size_t front)
+	{
+		// Count each column's entries, and those to go to its front.
+		std::vector<int> fronts(last >= first ? last - first + 1 : 0, 0);
+
+		mOffsets.assign(fronts.size() + 1, 0);
+
+		for (std::size_t i = 0; i < mSpans.size(); ++i)
+		{
+			int column = mSpans[i].mY - first;
+
+			++mOffsets[column + 1];
+
+			if (i >= front) ++fronts[column];
+		}
+
+		// Accumulate the offsets. Each column is split at the end of its front half, from
+		// which the back half fills forward and the front half fills backward.
+		for (std::size_t column = 0; column < fronts.size(); ++column)
+		{
+			mOffsets[column + 1] += mOffsets[column];
+
+			fronts[column] += mOffsets[column];
+		}
+
+		std::vector<int> backs(fronts);
+		std::vector<Entry> spans(mSpans.size());
+
+		for (std::size_t i = 0; i < mSpans.size(); ++i)
+		{
+			int column = mSpans[i].mY - first;
+
+			spans[i >= front ? --fronts[column] : backs[column]++] = mSpans[i];
+		}
+
+		mSpans.swap(spans);
+		mFirst = first;
+	}
+}
\ No newline at end of file
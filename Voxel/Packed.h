@@ -0,0 +1,170 @@
+#ifndef VOXEL_PACKED_H
+#define VOXEL_PACKED_H
+
+#include "Voxel.h"
+#include <algorithm>
+
+namespace Voxel
+{
+	/// @brief Packed span entry
+	struct Entry {
+		int mX1;///< x-cell of span start
+		int mX2;///< x-cell of span end
+		int mY;	///< y-cell of span
+		int mZ;	///< z-cell of span
+	};
+
+	/// @brief Spans in standard form, packed column by column into one array
+	struct Packed : public Shape<Packed> {
+		/// @brief Column step information
+		struct CStep {
+			// Members
+			int mY;	///< Column cell
+
+			// Methods
+			bool operator == (CStep const & si) const { return mY == si.mY; }
+
+			int M1 (void) const { return mY; }
+		};
+
+		/// @brief Row step information
+		struct RStep {
+			// Members
+			Entry const * mSpans;	///< Packed spans
+			int mIndex;	///< Index of current span; one off the column's end past the last
+
+			// Methods
+			bool operator == (RStep const & si) const { return mIndex == si.mIndex; }
+
+			void XSpan (int & x1, int & x2) const;
+
+			int M1 (void) const { return mSpans[mIndex].mZ; }
+		};
+
+		/// @brief Span step information
+		struct SStep {
+			// Members
+			int mI;	///< Initial span cell
+			int mF;	///< Final span cell
+			bool mEnd;	///< If true, span iterator is at end
+
+			// Methods
+			bool operator == (SStep const & si) const { return mEnd == si.mEnd; }
+
+			int M1 (void) const { return mI; }
+			int M2 (void) const { return mF; }
+		};
+
+		// Members
+		std::vector<Entry> mSpans;	///< Spans, packed column by column
+		std::vector<int> mOffsets;	///< Per column, offset of its first span; one past the end closes the last
+		int mFirst;	///< First column cell
+
+		// Lifetime
+		Packed (float dx, float dy, float dz) : Shape<Packed>(dx, dy, dz), mOffsets(1, 0), mFirst(0) {}
+
+		// Methods
+		void AddEntry (int x1, int x2, int y, int z);
+		void EdgeC (CStep & csi, bool bEnd, bool bReverse);
+		void EdgeR (CStep const & csi, RStep & rsi, bool bEnd, bool bReverse);
+		void EdgeS (RStep const & rsi, SStep & ssi, bool bEnd, bool bReverse);
+
+		std::size_t GetSpanCount (void);
+		std::size_t GetSpans (int * spans, std::size_t first, std::size_t count);
+
+		void Pack (int first, int last, std::size_t front);
+		void StepC (CStep & csi, bool bReverse, bool bDec);
+		void StepR (RStep & rsi, bool bReverse, bool bDec);
+		void StepS (SStep & ssi, bool bReverse, bool bDec);
+	};
+
+	/// @brief Gets the span for this entry
+	/// @param x1 [out] Initial span cell
+	/// @param x2 [out] Final span cell
+	inline void Packed::RStep::XSpan (int & x1, int & x2) const
+	{
+		x1 = mSpans[mIndex].mX1;
+		x2 = mSpans[mIndex].mX2;
+	}
+
+	/// @brief Gets an edge column iterator
+	/// @param csi [out] Column step info
+	/// @param bEnd If true, get the end iterator
+	/// @param bReverse If true, get reverse info
+	inline void Packed::EdgeC (CStep & csi, bool bEnd, bool bReverse)
+	{
+		int last = mFirst + int(mOffsets.size()) - 2;
+
+		if (bReverse) csi.mY = bEnd ? mFirst - 1 : last;
+
+		else csi.mY = bEnd ? last + 1 : mFirst;
+	}
+
+	/// @brief Gets an edge row iterator
+	/// @param csi Column step info
+	/// @param rsi [out] Row step info
+	/// @param bEnd If true, get the end iterator
+	/// @param bReverse If true, get reverse info
+	inline void Packed::EdgeR (CStep const & csi, RStep & rsi, bool bEnd, bool bReverse)
+	{
+		int column = csi.mY - mFirst;
+
+		if (bReverse) rsi.mIndex = bEnd ? mOffsets[column] - 1 : mOffsets[column + 1] - 1;
+
+		else rsi.mIndex = bEnd ? mOffsets[column + 1] : mOffsets[column];
+
+		rsi.mSpans = mSpans.empty() ? 0 : &mSpans[0];
+	}
+
+	/// @brief Gets an edge span iterator
+	/// @param rsi Row step info
+	/// @param ssi [out] Span step info
+	/// @param bEnd If true, get the end iterator
+	/// @param bReverse If true, get reverse info
+	inline void Packed::EdgeS (RStep const & rsi, SStep & ssi, bool bEnd, bool bReverse)
+	{
+		if (bEnd) ssi.mEnd = true;
+
+		else
+		{
+			ssi.mEnd = false;
+
+			rsi.XSpan(ssi.mI, ssi.mF);
+
+			if (bReverse) std::swap(ssi.mI, ssi.mF);
+		}
+	}
+
+	/// @brief Steps along a column
+	/// @param csi Column step info
+	/// @param bReverse If true, step in reverse
+	/// @param bDec If true, decrement
+	inline void Packed::StepC (CStep & csi, bool bReverse, bool bDec)
+	{
+		int dY = bDec ? -1 : +1;
+
+		csi.mY += bReverse ? -dY : +dY;
+	}
+
+	/// @brief Steps along a row
+	/// @param rsi Row step info
+	/// @param bReverse If true, step in reverse
+	/// @param bDec If true, decrement
+	inline void Packed::StepR (RStep & rsi, bool bReverse, bool bDec)
+	{
+		int dI = bDec ? -1 : +1;
+
+		rsi.mIndex += bReverse ? -dI : +dI;
+	}
+
+	/// @brief Steps along a span
+	/// @param ssi Span step info
+	/// @param bReverse Unused, as a row holds one span
+	/// @param bDec Unused, as a row holds one span
+	inline void Packed::StepS (SStep & ssi, bool /* bReverse */, bool /* bDec */)
+	{
+		ssi.mEnd = true;
+	}
+}
+
+#endif // VOXEL_PACKED_H
\ No newline at end of file
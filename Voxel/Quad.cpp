@@ -0,0 +1,37 @@
+#include "Quad.h"
+
+namespace Voxel
+{
+	/// @brief Constructs a Quad object
+	/// @param corner Quad corner, relative to space origin
+	/// @param u Edge from the corner to one neighbor
+	/// @param v Edge from the corner to the other neighbor
+	/// @param thickness Slab thickness
+	/// @param dx Extent of space cell in x-direction
+	/// @param dy Extent of space cell in y-direction
+	/// @param dz Extent of space cell in z-direction
+	/// @param order Order used to obtain spans
+	Quad::Quad (float corner[3], float u[3], float v[3], float thickness, float dx, float dy, float dz, Order order) : OBox(dx, dy, dz, order)
+	{
+		if (thickness < 0.0f) throw "Negative thickness";
+
+		float n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+		float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+		if (len == 0.0f) throw "Degenerate quad";
+
+		// Build the slab as a box about the quad's center, with half the edges and thickness.
+		float center[3], axes[3][3];
+
+		for (int k = 0; k < 3; ++k)
+		{
+			center[k] = corner[k] + 0.5f * (u[k] + v[k]);
+
+			axes[0][k] = 0.5f * u[k];
+			axes[1][k] = 0.5f * v[k];
+			axes[2][k] = 0.5f * thickness * n[k] / len;
+		}
+
+		Build(center, axes);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef VOXEL_QUAD_H
+#define VOXEL_QUAD_H
+
+#include "Voxel.h"
+#include "VoxelImp.h"
+#include "OBox.h"
+
+namespace Voxel
+{
+	/// @brief Quad slab data, e.g. for a wall
+	/// @note The slab is the parallelogram thickened evenly to either side
+	struct Quad : public OBox {
+		// Lifetime
+		Quad (float corner[3], float u[3], float v[3], float thickness, float dx, float dy, float dz, Order order);
+	};
+}
+
+#endif // VOXEL_QUAD_H
\ No newline at end of file
@@ -3,27 +3,17 @@
 
 #include "Voxel.h"
 #include "VoxelImp.h"
-#include <list>
+#include "Packed.h"
 
 namespace Voxel
 {
-	/// @brief Sphere entry
-	struct Entry {
-		int mX1;///< x-cell of span start
-		int mX2;///< x-cell of span end
-		int mZ;	///< z-cell of span
-	};
-
-	typedef std::list<Entry> EntryList;
-
 	/// @brief Sphere data
-	struct Sphere : public Data {
+	struct Sphere : public Packed {
 		// Members
-		std::vector<EntryList> mColumn;	///< Column of span lists
 		Cell mCenter;	///< Center cell values
 		Cell mMin;	///< Minimum cell values
 		Cell mMax;	///< Maximum cell values
-		void (EntryList::* mOp)(Entry const &);	///< Operation used to add span to row
+		std::size_t mFront;	///< While building, index of the first span to go to the front of its column
 		float mXL;	///< Distance of center from lesser x-plane
 		float mXG;	///< Distance of center from greater x-plane
 		float mYL;	///< Distance of center from y-plane above bottom point
@@ -36,15 +26,7 @@ namespace Voxel
 		Sphere (float center[3], float radius, float dx, float dy, float dz, Order order);
 
 		// Methods
-		StepInfo * EdgeC (bool bEnd, bool bReverse);
-		StepInfo * EdgeR (StepInfo * csi, bool bEnd, bool bReverse);
-		StepInfo * EdgeS (StepInfo * rsi, bool bEnd, bool bReverse);
-
-		void AddEntry (int x1, int x2, int y, int z);
 		void Extend (TripleIndex index, float & cL, float & cG);
-		void StepC (StepInfo * csi, bool bReverse, bool bDec);
-		void StepR (StepInfo * rsi, bool bReverse, bool bDec);
-		void StepS (StepInfo * ssi, bool bReverse, bool bDec);
 		void XYSemicircle (float z, int dZ, int count);
 		void ZCircle (float yL, float yG, float z, int cyL, int cyG, int cZ);
 		void ZSemicircle (float y, float res, int cY, int dY, int cZ);
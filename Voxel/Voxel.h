@@ -1,7 +1,6 @@
 #ifndef VOXEL_H
 #define VOXEL_H
 
-#include <list>
 #include <vector>
 
 namespace Voxel
@@ -17,16 +16,9 @@ namespace Voxel
 	};
 
 	// Forward references
-	struct StepInfo;
-	class ColumnIter;
-	class ColumnIterF;
-	class ColumnIterR;
-	class RowIter;
-	class RowIterF;
-	class RowIterR;
-	class SpanIter;
-	class SpanIterF;
-	class SpanIterR;
+	template<typename S, bool bReverse> class ColumnIter;
+	template<typename S, bool bReverse> class RowIter;
+	template<typename S, bool bReverse> class SpanIter;
 
 	/// @brief Data base class
 	class Data {
@@ -36,201 +28,389 @@ namespace Voxel
 
 		// Lifetime
 		Data (float dx, float dy, float dz);
-		virtual ~Data (void) {}
-
-		// Methods
-		virtual StepInfo * EdgeC (bool bEnd, bool bReverse) = 0;
-		virtual StepInfo * EdgeR (StepInfo * csi, bool bEnd, bool bReverse) = 0;
-		virtual StepInfo * EdgeS (StepInfo * rsi, bool bEnd, bool bReverse) = 0;
-		virtual void StepC (StepInfo * csi, bool bReverse, bool bDec) = 0;
-		virtual void StepR (StepInfo * rsi, bool bReverse, bool bDec) = 0;
-		virtual void StepS (StepInfo * ssi, bool bReverse, bool bDec) = 0;
-
-		// Friendship
-		friend class ColumnIter;
-		friend class ColumnIterF;
-		friend class ColumnIterR;
-		friend class RowIter;
-		friend class RowIterF;
-		friend class RowIterR;
-		friend class SpanIter;
-		friend class SpanIterF;
-		friend class SpanIterR;
-	public:
-		// Methods
-		ColumnIterF begin (void);
-		ColumnIterR rbegin (void);
-		ColumnIterF end (void);
-		ColumnIterR rend (void);
 	};
 
-	/// @brief Base iterator type
-	class Iter {
+	/// @brief Shape base class
+	/// @note S is the shape type itself, which supplies the column, row, and span step info
+	///       types (CStep, RStep, SStep) and their Edge* and Step* methods; iterators hold
+	///       the step info by value and call these directly, without allocating
+	template<typename S> class Shape : public Data {
 	protected:
-		// Members
-		StepInfo * mSI;	///< Step info
-		Data * mVD;	///< Voxel data
-
 		// Lifetime
-		Iter (StepInfo * si, Data * vd) : mSI(si), mVD(vd) {}
-		virtual ~Iter (void);
+		Shape (float dx, float dy, float dz) : Data(dx, dy, dz) {}
 	public:
-		// Methods
-		bool operator == (Iter const & v);
-		bool operator != (Iter const & v);
-	};
+		// Types
+		typedef ColumnIter<S, false> ColumnIterF;
+		typedef ColumnIter<S, true> ColumnIterR;
+		typedef RowIter<S, false> RowIterF;
+		typedef RowIter<S, true> RowIterR;
+		typedef SpanIter<S, false> SpanIterF;
+		typedef SpanIter<S, true> SpanIterR;
 
-	/// @brief Base column iterator
-	class ColumnIter : public Iter {
-	protected:
-		// Lifetime
-		ColumnIter (StepInfo * si, Data * vd) : Iter(si, vd) {}
-	public:
 		// Methods
-		int operator * (void);
-
-		RowIterF begin (void);
-		RowIterF end (void);
-		RowIterR rbegin (void);
-		RowIterR rend (void);
+		ColumnIterF begin (void);
+		ColumnIterR rbegin (void);
+		ColumnIterF end (void);
+		ColumnIterR rend (void);
 
-		virtual void operator ++ (void) = 0;
-		virtual void operator -- (void) = 0;
+		std::size_t GetSpanCount (void);
+		std::size_t GetSpans (int * spans, std::size_t first, std::size_t count);
 	};
 
-	/// @brief Forward column iterator
-	class ColumnIterF : public ColumnIter {
+	/// @brief Column iterator
+	template<typename S, bool bReverse> class ColumnIter {
 	private:
+		// Members
+		typename S::CStep mSI;	///< Step info
+		S * mVD;///< Voxel data
+
 		// Lifetime
-		ColumnIterF (StepInfo * si, Data * vd) : ColumnIter(si, vd) {}
+		ColumnIter (S * vd, bool bEnd);
 
 		// Friendship
-		friend class Data;
+		friend class Shape<S>;
 	public:
-		// Lifetime
-		ColumnIterF (ColumnIterF const & vo);
-
 		// Methods
-		void operator ++ (void);
-		void operator -- (void);
-	};
+		bool operator == (ColumnIter const & v) const;
+		bool operator != (ColumnIter const & v) const;
 
-	/// @brief Reverse column iterator
-	class ColumnIterR : public ColumnIter {
-	private:
-		// Lifetime
-		ColumnIterR (StepInfo * si, Data * vd) : ColumnIter(si, vd) {}
+		int operator * (void) const;
 
-		// Friendship
-		friend class Data;
-	public:
-		// Lifetime
-		ColumnIterR (ColumnIterR const & vo);
+		RowIter<S, false> begin (void) const;
+		RowIter<S, false> end (void) const;
+		RowIter<S, true> rbegin (void) const;
+		RowIter<S, true> rend (void) const;
 
-		// Methods
 		void operator ++ (void);
 		void operator -- (void);
 	};
 
-	/// @brief Base row iterator
-	class RowIter : public Iter {
-	protected:
-		// Lifetime
-		RowIter (StepInfo * si, Data * vd) : Iter(si, vd) {}
-	public:
-		// Methods
-		int operator * (void);
-
-		SpanIterF begin (void);
-		SpanIterF end (void);
-		SpanIterR rbegin (void);
-		SpanIterR rend (void);
-
-		virtual void operator ++ (void) = 0;
-		virtual void operator -- (void) = 0;
-	};
-
-	/// @brief Forward row iterator
-	class RowIterF : public RowIter {
+	/// @brief Row iterator
+	template<typename S, bool bReverse> class RowIter {
 	private:
+		// Members
+		typename S::RStep mSI;	///< Step info
+		S * mVD;///< Voxel data
+
 		// Lifetime
-		RowIterF (StepInfo * si, Data * vd) : RowIter(si, vd) {}
+		RowIter (S * vd, typename S::CStep const & csi, bool bEnd);
 
 		// Friendship
-		friend class ColumnIter;
+		template<typename T, bool bR> friend class ColumnIter;
 	public:
-		// Lifetime
-		RowIterF (RowIterF const & vo);
-
 		// Methods
-		void operator ++ (void);
-		void operator -- (void);
-	};
+		bool operator == (RowIter const & v) const;
+		bool operator != (RowIter const & v) const;
 
-	/// @brief Reverse row iterator
-	class RowIterR : public RowIter {
-	private:
-		// Lifetime
-		RowIterR (StepInfo * si, Data * vd) : RowIter(si, vd) {}
+		int operator * (void) const;
 
-		// Friendship
-		friend class ColumnIter;
-	public:
-		// Lifetime
-		RowIterR (RowIterR const & vo);
+		SpanIter<S, false> begin (void) const;
+		SpanIter<S, false> end (void) const;
+		SpanIter<S, true> rbegin (void) const;
+		SpanIter<S, true> rend (void) const;
 
-		// Methods
 		void operator ++ (void);
 		void operator -- (void);
 	};
 
-	/// @brief Base span iterator
-	class SpanIter : public Iter {
-	protected:
-		// Lifetime
-		SpanIter (StepInfo * si, Data * vd) : Iter(si, vd) {}
-	public:
-		// Methods
-		int I (void);
-		int F (void);
-
-		virtual void operator ++ (void) = 0;
-		virtual void operator -- (void) = 0;
-	};
-
-	/// @brief Forward span iterator
-	class SpanIterF : public SpanIter {
+	/// @brief Span iterator
+	template<typename S, bool bReverse> class SpanIter {
 	private:
+		// Members
+		typename S::SStep mSI;	///< Step info
+		S * mVD;///< Voxel data
+
 		// Lifetime
-		SpanIterF (StepInfo * si, Data * vd) : SpanIter(si, vd) {}
+		SpanIter (S * vd, typename S::RStep const & rsi, bool bEnd);
 
 		// Friendship
-		friend class RowIter;
+		template<typename T, bool bR> friend class RowIter;
 	public:
-		// Lifetime
-		SpanIterF (SpanIterF const & vo);
-
 		// Methods
-		void operator ++ (void);
-		void operator -- (void);
-	};
+		bool operator == (SpanIter const & v) const;
+		bool operator != (SpanIter const & v) const;
 
-	/// @brief Reverse span iterator
-	class SpanIterR : public SpanIter {
-	private:
-		// Lifetime
-		SpanIterR (StepInfo * si, Data * vd) : SpanIter(si, vd) {}
+		int I (void) const;
+		int F (void) const;
 
-		// Friendship
-		friend class RowIter;
-	public:
-		// Lifetime
-		SpanIterR (SpanIterR const & vo);
-
-		// Methods
 		void operator ++ (void);
 		void operator -- (void);
 	};
+
+	/// @brief Gets the voxel data's begin forward iterator
+	/// @return Forward iterator
+	template<typename S> inline typename Shape<S>::ColumnIterF Shape<S>::begin (void)
+	{
+		return ColumnIterF(static_cast<S*>(this), false);
+	}
+
+	/// @brief Gets the voxel data's begin reverse iterator
+	/// @return Reverse iterator
+	template<typename S> inline typename Shape<S>::ColumnIterR Shape<S>::rbegin (void)
+	{
+		return ColumnIterR(static_cast<S*>(this), false);
+	}
+
+	/// @brief Gets the voxel data's end forward iterator
+	/// @return Forward iterator
+	template<typename S> inline typename Shape<S>::ColumnIterF Shape<S>::end (void)
+	{
+		return ColumnIterF(static_cast<S*>(this), true);
+	}
+
+	/// @brief Gets the voxel data's end reverse iterator
+	/// @return Reverse iterator
+	template<typename S> inline typename Shape<S>::ColumnIterR Shape<S>::rend (void)
+	{
+		return ColumnIterR(static_cast<S*>(this), true);
+	}
+
+	/// @brief Gets the count of spans in the shape
+	/// @return Span count
+	/// @note Shapes that keep their spans packed may hide this with a direct count
+	template<typename S> inline std::size_t Shape<S>::GetSpanCount (void)
+	{
+		std::size_t count = 0;
+
+		for (ColumnIterF ci = begin(); ci != end(); ++ci)
+		{
+			for (RowIterF ri = ci.begin(); ri != ci.end(); ++ri)
+			{
+				for (SpanIterF si = ri.begin(); si != ri.end(); ++si) ++count;
+			}
+		}
+
+		return count;
+	}
+
+	/// @brief Writes a run of spans into a buffer, in forward order
+	/// @param spans [out] Buffer that receives the spans, as (column, row, initial, final) cells
+	/// @param first Index of first span to write; successive runs may be streamed in chunks
+	/// @param count Greatest count of spans to write
+	/// @return Count of spans written; if 0, the spans are exhausted
+	/// @note Shapes that keep their spans packed may hide this with a direct copy
+	template<typename S> inline std::size_t Shape<S>::GetSpans (int * spans, std::size_t first, std::size_t count)
+	{
+		std::size_t index = 0, written = 0;
+
+		for (ColumnIterF ci = begin(); ci != end(); ++ci)
+		{
+			for (RowIterF ri = ci.begin(); ri != ci.end(); ++ri)
+			{
+				for (SpanIterF si = ri.begin(); si != ri.end(); ++si, ++index)
+				{
+					if (index < first) continue;
+
+					if (written == count) return written;
+
+					spans[0] = *ci;
+					spans[1] = *ri;
+					spans[2] = si.I();
+					spans[3] = si.F();
+
+					spans += 4;
+
+					++written;
+				}
+			}
+		}
+
+		return written;
+	}
+
+	/// @brief Constructs a ColumnIter object
+	/// @param vd Voxel data
+	/// @param bEnd If true, construct the end iterator
+	template<typename S, bool bReverse> inline ColumnIter<S, bReverse>::ColumnIter (S * vd, bool bEnd) : mVD(vd)
+	{
+		vd->EdgeC(mSI, bEnd, bReverse);
+	}
+
+	/// @brief Compares two column iterators for equality
+	/// @param v Iterator to compare
+	/// @return Equality boolean
+	template<typename S, bool bReverse> inline bool ColumnIter<S, bReverse>::operator == (ColumnIter const & v) const
+	{
+		return mSI == v.mSI;
+	}
+
+	/// @brief Compares two column iterators for inequality
+	/// @param v Iterator to compare
+	/// @return Inequality boolean
+	template<typename S, bool bReverse> inline bool ColumnIter<S, bReverse>::operator != (ColumnIter const & v) const
+	{
+		return !(mSI == v.mSI);
+	}
+
+	/// @brief Dereferences the column iterator
+	/// @return Column cell
+	template<typename S, bool bReverse> inline int ColumnIter<S, bReverse>::operator * (void) const
+	{
+		return mSI.M1();
+	}
+
+	/// @brief Gets the column's begin forward iterator
+	/// @return Forward iterator
+	template<typename S, bool bReverse> inline RowIter<S, false> ColumnIter<S, bReverse>::begin (void) const
+	{
+		return RowIter<S, false>(mVD, mSI, false);
+	}
+
+	/// @brief Gets the column's end forward iterator
+	/// @return Forward iterator
+	template<typename S, bool bReverse> inline RowIter<S, false> ColumnIter<S, bReverse>::end (void) const
+	{
+		return RowIter<S, false>(mVD, mSI, true);
+	}
+
+	/// @brief Gets the column's begin reverse iterator
+	/// @return Reverse iterator
+	template<typename S, bool bReverse> inline RowIter<S, true> ColumnIter<S, bReverse>::rbegin (void) const
+	{
+		return RowIter<S, true>(mVD, mSI, false);
+	}
+
+	/// @brief Gets the column's end reverse iterator
+	/// @return Reverse iterator
+	template<typename S, bool bReverse> inline RowIter<S, true> ColumnIter<S, bReverse>::rend (void) const
+	{
+		return RowIter<S, true>(mVD, mSI, true);
+	}
+
+	/// @brief Increments the column iterator
+	template<typename S, bool bReverse> inline void ColumnIter<S, bReverse>::operator ++ (void)
+	{
+		mVD->StepC(mSI, bReverse, false);
+	}
+
+	/// @brief Decrements the column iterator
+	template<typename S, bool bReverse> inline void ColumnIter<S, bReverse>::operator -- (void)
+	{
+		mVD->StepC(mSI, bReverse, true);
+	}
+
+	/// @brief Constructs a RowIter object
+	/// @param vd Voxel data
+	/// @param csi Column step info
+	/// @param bEnd If true, construct the end iterator
+	template<typename S, bool bReverse> inline RowIter<S, bReverse>::RowIter (S * vd, typename S::CStep const & csi, bool bEnd) : mVD(vd)
+	{
+		vd->EdgeR(csi, mSI, bEnd, bReverse);
+	}
+
+	/// @brief Compares two row iterators for equality
+	/// @param v Iterator to compare
+	/// @return Equality boolean
+	template<typename S, bool bReverse> inline bool RowIter<S, bReverse>::operator == (RowIter const & v) const
+	{
+		return mSI == v.mSI;
+	}
+
+	/// @brief Compares two row iterators for inequality
+	/// @param v Iterator to compare
+	/// @return Inequality boolean
+	template<typename S, bool bReverse> inline bool RowIter<S, bReverse>::operator != (RowIter const & v) const
+	{
+		return !(mSI == v.mSI);
+	}
+
+	/// @brief Dereferences the row iterator
+	/// @return Row cell
+	template<typename S, bool bReverse> inline int RowIter<S, bReverse>::operator * (void) const
+	{
+		return mSI.M1();
+	}
+
+	/// @brief Gets the row's begin forward iterator
+	/// @return Forward iterator
+	template<typename S, bool bReverse> inline SpanIter<S, false> RowIter<S, bReverse>::begin (void) const
+	{
+		return SpanIter<S, false>(mVD, mSI, false);
+	}
+
+	/// @brief Gets the row's end forward iterator
+	/// @return Forward iterator
+	template<typename S, bool bReverse> inline SpanIter<S, false> RowIter<S, bReverse>::end (void) const
+	{
+		return SpanIter<S, false>(mVD, mSI, true);
+	}
+
+	/// @brief Gets the row's begin reverse iterator
+	/// @return Reverse iterator
+	template<typename S, bool bReverse> inline SpanIter<S, true> RowIter<S, bReverse>::rbegin (void) const
+	{
+		return SpanIter<S, true>(mVD, mSI, false);
+	}
+
+	/// @brief Gets the row's end reverse iterator
+	/// @return Reverse iterator
+	template<typename S, bool bReverse> inline SpanIter<S, true> RowIter<S, bReverse>::rend (void) const
+	{
+		return SpanIter<S, true>(mVD, mSI, true);
+	}
+
+	/// @brief Increments the row iterator
+	template<typename S, bool bReverse> inline void RowIter<S, bReverse>::operator ++ (void)
+	{
+		mVD->StepR(mSI, bReverse, false);
+	}
+
+	/// @brief Decrements the row iterator
+	template<typename S, bool bReverse> inline void RowIter<S, bReverse>::operator -- (void)
+	{
+		mVD->StepR(mSI, bReverse, true);
+	}
+
+	/// @brief Constructs a SpanIter object
+	/// @param vd Voxel data
+	/// @param rsi Row step info
+	/// @param bEnd If true, construct the end iterator
+	template<typename S, bool bReverse> inline SpanIter<S, bReverse>::SpanIter (S * vd, typename S::RStep const & rsi, bool bEnd) : mVD(vd)
+	{
+		vd->EdgeS(rsi, mSI, bEnd, bReverse);
+	}
+
+	/// @brief Compares two span iterators for equality
+	/// @param v Iterator to compare
+	/// @return Equality boolean
+	template<typename S, bool bReverse> inline bool SpanIter<S, bReverse>::operator == (SpanIter const & v) const
+	{
+		return mSI == v.mSI;
+	}
+
+	/// @brief Compares two span iterators for inequality
+	/// @param v Iterator to compare
+	/// @return Inequality boolean
+	template<typename S, bool bReverse> inline bool SpanIter<S, bReverse>::operator != (SpanIter const & v) const
+	{
+		return !(mSI == v.mSI);
+	}
+
+	/// @brief Gets the initial element of the span
+	/// @return Initial cell
+	template<typename S, bool bReverse> inline int SpanIter<S, bReverse>::I (void) const
+	{
+		return mSI.M1();
+	}
+
+	/// @brief Gets the final element of the span
+	/// @return Final cell
+	template<typename S, bool bReverse> inline int SpanIter<S, bReverse>::F (void) const
+	{
+		return mSI.M2();
+	}
+
+	/// @brief Increments the span iterator
+	template<typename S, bool bReverse> inline void SpanIter<S, bReverse>::operator ++ (void)
+	{
+		mVD->StepS(mSI, bReverse, false);
+	}
+
+	/// @brief Decrements the span iterator
+	template<typename S, bool bReverse> inline void SpanIter<S, bReverse>::operator -- (void)
+	{
+		mVD->StepS(mSI, bReverse, true);
+	}
 }
 
 #endif // VOXEL_H
\ No newline at end of file
@@ -28,6 +28,20 @@ namespace Voxel
 		dG = (m[index] + 0.5f) * dim[index] - center[index], dL = dim[index] - dG;
 	}
 
+	/// @brief Gets the axes along which an ordering steps
+	/// @param order Volume ordering
+	/// @param axes [out] Axes of columns, rows, and spans, in turn; 0, 1, 2 are x, y, z
+	/// @note Orderings are named for their column, row, and span axes, e.g. eYZX steps by
+	///       y-column, then z-row, with spans along x, which is the standard form
+	void GetAxes (Order order, int axes[3])
+	{
+		static const int sAxes[][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+
+		axes[0] = sAxes[order][0];
+		axes[1] = sAxes[order][1];
+		axes[2] = sAxes[order][2];
+	}
+
 	/// @brief Constructs a Data object
 	/// @param dx Extent of space cell in x-direction
 	/// @param dy Extent of space cell in y-direction
@@ -42,54 +56,4 @@ namespace Voxel
 		mD[eTY] = dy;
 		mD[eTZ] = dz;
 	}
-
-	/// @brief Gets the voxel data's begin forward iterator
-	/// @return Forward iterator
-	ColumnIterF Data::begin (void)
-	{
-		return ColumnIterF(EdgeC(false, false), this);
-	}
-
-	/// @brief Gets the voxel data's end forward iterator
-	/// @return Forward iterator
-	ColumnIterF Data::end (void)
-	{
-		return ColumnIterF(EdgeC(true, false), this);
-	}
-
-	/// @brief Gets the voxel data's begin reverse iterator
-	/// @return Reverse iterator
-	ColumnIterR Data::rbegin (void)
-	{
-		return ColumnIterR(EdgeC(false, true), this);
-	}
-
-	/// @brief Gets the voxel data's end reverse iterator
-	/// @return Reverse iterator
-	ColumnIterR Data::rend (void)
-	{
-		return ColumnIterR(EdgeC(true, true), this);
-	}
-
-	/// @brief Destructs a Iter object
-	Iter::~Iter (void)
-	{
-		delete mSI;
-	}
-
-	/// @brief Compares two iterators for equality
-	/// @param v Iterator to compare
-	/// @return Equality boolean
-	bool Iter::operator == (Iter const & v)
-	{
-		return *mSI == *v.mSI;
-	}
-
-	/// @brief Compares two iterators for inequality
-	/// @param v Iterator to compare
-	/// @return Inequality boolean
-	bool Iter::operator != (Iter const & v)
-	{
-		return !(*mSI == *v.mSI);
-	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef VOXEL_IMP_H
 #define VOXEL_IMP_H
 
+#include "Voxel.h"
+
 namespace Voxel
 {
 	/// @brief Triple indices
@@ -10,31 +12,21 @@ namespace Voxel
 		eTZ	///< z-index
 	};
 
+	// Helpers
+	void GetAxes (Order order, int axes[3]);
+
 	/// @brief Cell coordinates
 	struct Cell	{
 		// Members
 		int m[3];	///< Cell offsets
 
 		// Lifetime
+		Cell (void) {}
 		Cell (float v[3], float dx, float dy, float dz, float delta);
 
 		// Methods
 		void Distances (TripleIndex index, float center[3], float dim[3], float & dL, float & dG);
 	};
-
-	/// @brief Base step information type
-	struct StepInfo {
-		// Lifetime
-		virtual ~StepInfo (void) {};
-
-		// Methods
-		virtual bool operator == (StepInfo & si) = 0;
-
-		virtual StepInfo * Copy (void) = 0;
-
-		virtual int M1 (void) = 0;
-		virtual int M2 (void) { return M1(); }
-	};
 }
 
 #endif // VOXEL_IMP_H
\ No newline at end of file